@@ -0,0 +1,1412 @@
+﻿// Bench.cpp
+// CS499 – Final ePortfolio Artifact (Advising Assistance Program)
+//
+// Description:
+// Microbenchmarks run with --bench NAME: each times a structure of the
+// planner against the simpler one it replaced, on synthetic catalogs of
+// up to millions of courses (see Bench.h), and flags a result that
+// differs between the two with "! ... mismatch". Tests.cpp checks the
+// same structures for correctness on small inputs.
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "Bench.h"
+#include "Catalog.h"
+#include "CodeQuery.h"
+#include "Snapshot.h"
+
+// Best wall time of `reps` runs, in milliseconds.
+template <class Fn>
+static double bestOfMs(int reps, Fn&& fn) {
+    double best = 1e300;
+    for (int r = 0; r < reps; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        std::chrono::duration<double, std::milli> ms = std::chrono::steady_clock::now() - start;
+        best = std::min(best, ms.count());
+    }
+    return best;
+}
+
+// Per-call latency of one(i) for i in [0, n), timed in batches of `batch`
+// calls so that the clock's own cost stays out of short calls: median,
+// 99th and 99.9th percentile in nanoseconds, and the sum of what one
+// returned, to check one method against another.
+struct Latency {
+    double p50, p99, p999;
+    size_t results;
+};
+
+template <class One>
+static Latency measureLatency(size_t n, size_t batch, One&& one) {
+    std::vector<double> ns;
+    ns.reserve(n / batch);
+    size_t results = 0;
+    for (size_t i = 0; i + batch <= n; i += batch) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t k = i; k < i + batch; ++k) results += one(k);
+        std::chrono::duration<double, std::nano> d = std::chrono::steady_clock::now() - start;
+        ns.push_back(d.count() / batch);
+    }
+    std::sort(ns.begin(), ns.end());
+    auto at = [&](double q) { return ns[(size_t)(q * (ns.size() - 1))]; };
+    return { at(0.5), at(0.99), at(0.999), results };
+}
+
+static void printBenchRow(const std::string& name, double ms, double baseMs, double mb) {
+    std::cout << "  " << std::left << std::setw(22) << name << std::right
+        << std::fixed << std::setprecision(2) << std::setw(10) << ms << " ms"
+        << std::setw(10) << (mb / (ms / 1000.0)) << " MB/s"
+        << std::setw(8) << (baseMs / ms) << "x\n";
+    std::cout.unsetf(std::ios::floatfield);
+}
+
+static void benchSplitCSV() {
+    const size_t rows = 50000, cols = 40;
+    std::string buf = makeWideCSV(rows, cols);
+    double mb = buf.size() / (1024.0 * 1024.0);
+    std::cout << "splitCSV vs. CsvScanner: " << rows << " rows x " << (cols + 2)
+        << " fields (" << std::fixed << std::setprecision(1) << mb << " MB)\n";
+    std::cout.unsetf(std::ios::floatfield);
+
+    size_t expected = 0;
+    double baseMs = bestOfMs(3, [&] {
+        size_t fieldCount = 0, pos = 0;
+        while (pos < buf.size()) {
+            size_t end = buf.find('\n', pos);
+            if (end == std::string::npos) end = buf.size();
+            fieldCount += splitCSV(buf.substr(pos, end - pos)).size();
+            pos = end + 1;
+        }
+        expected = fieldCount;
+    });
+    printBenchRow("splitCSV (getline)", baseMs, baseMs, mb);
+
+    for (const auto& k : csvKernels()) {
+        if (!k.supported) {
+            std::cout << "  " << std::left << std::setw(22) << ("scan/" + std::string(k.name))
+                << std::right << "  (not supported on this CPU)\n";
+            continue;
+        }
+        size_t fieldCount = 0;
+        double ms = bestOfMs(5, [&] {
+            CsvScanner scanner(k.fn);
+            std::vector<std::string_view> fields;
+            fieldCount = 0;
+            scanner.forEachRecord(buf, fields,
+                [&](std::string_view, const std::vector<std::string_view>& f) { fieldCount += f.size(); });
+        });
+        printBenchRow("scan/" + std::string(k.name), ms, baseMs, mb);
+        if (fieldCount != expected)
+            std::cout << "  ! field count mismatch: " << fieldCount << " vs " << expected << "\n";
+    }
+}
+
+// Kahn's algorithm with a FIFO frontier; returns the number of nodes output.
+template <class Successors>
+static size_t kahnCount(size_t nodes, std::vector<uint32_t> indegree, Successors&& successors) {
+    std::vector<CourseId> queue;
+    queue.reserve(nodes);
+    for (CourseId v = 0; v < nodes; ++v)
+        if (indegree[v] == 0) queue.push_back(v);
+    for (size_t head = 0; head < queue.size(); ++head)
+        for (CourseId v : successors(queue[head]))
+            if (--indegree[v] == 0) queue.push_back(v);
+    return queue.size();
+}
+
+static void benchGraph() {
+    const uint32_t nodes = 1000000;
+    auto edges = makeSyntheticDag(nodes, 42);
+    std::cout << "Graph build + Kahn traversal: " << nodes << " nodes, " << edges.size() << " edges\n";
+
+    std::vector<std::string> names(nodes);
+    for (uint32_t v = 0; v < nodes; ++v) names[v] = "C" + std::to_string(v);
+
+    // Previous layout: string keys, one heap vector of strings per node.
+    double mapBuild = 0, mapWalk = 0;
+    {
+        std::unordered_map<std::string, std::vector<std::string>> adj;
+        std::unordered_map<std::string, int> indegree;
+        auto t0 = std::chrono::steady_clock::now();
+        for (const auto& n : names) { adj[n]; indegree[n] = 0; }
+        for (const auto& e : edges) {
+            adj[names[e.first]].push_back(names[e.second]);
+            ++indegree[names[e.second]];
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        std::queue<std::string> q;
+        for (auto& kv : indegree) if (kv.second == 0) q.push(kv.first);
+        size_t out = 0;
+        while (!q.empty()) {
+            std::string u = q.front(); q.pop(); ++out;
+            for (auto& v : adj[u]) if (--indegree[v] == 0) q.push(v);
+        }
+        auto t2 = std::chrono::steady_clock::now();
+        mapBuild = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        mapWalk = std::chrono::duration<double, std::milli>(t2 - t1).count();
+        if (out != nodes) std::cout << "  ! string graph visited " << out << "\n";
+    }
+
+    // Vector of vectors over ids.
+    std::vector<std::vector<CourseId>> vadj;
+    std::vector<uint32_t> vdeg;
+    double vecBuild = bestOfMs(3, [&] {
+        vadj.assign(nodes, {});
+        vdeg.assign(nodes, 0);
+        for (const auto& e : edges) { vadj[e.first].push_back(e.second); ++vdeg[e.second]; }
+    });
+    size_t vecOut = 0;
+    double vecWalk = bestOfMs(3, [&] {
+        vecOut = kahnCount(nodes, vdeg, [&](CourseId u) -> const std::vector<CourseId>& { return vadj[u]; });
+    });
+
+    // CSR.
+    CsrGraph graph;
+    double csrBuild = bestOfMs(3, [&] {
+        buildGraph(graph, nodes, edges);
+    });
+    std::vector<uint32_t> cdeg(nodes);
+    for (CourseId v = 0; v < nodes; ++v) cdeg[v] = graph.indegree(v);
+    size_t csrOut = 0;
+    double csrWalk = bestOfMs(3, [&] {
+        csrOut = kahnCount(nodes, cdeg, [&](CourseId u) { return graph.successors(u); });
+    });
+    if (vecOut != nodes || csrOut != nodes) std::cout << "  ! traversal mismatch\n";
+
+    size_t vecBytes = vadj.capacity() * sizeof(std::vector<CourseId>) + vdeg.capacity() * 4;
+    for (const auto& row : vadj) vecBytes += row.capacity() * sizeof(CourseId);
+
+    std::cout << std::fixed << std::setprecision(1)
+        << "  " << std::left << std::setw(26) << "layout" << std::right
+        << std::setw(12) << "build ms" << std::setw(12) << "walk ms" << std::setw(12) << "MB\n"
+        << "  " << std::left << std::setw(26) << "unordered_map<string>" << std::right
+        << std::setw(12) << mapBuild << std::setw(12) << mapWalk << std::setw(12) << "-" << "\n"
+        << "  " << std::left << std::setw(26) << "vector<vector<id>>" << std::right
+        << std::setw(12) << vecBuild << std::setw(12) << vecWalk << std::setw(12) << vecBytes / 1048576.0 << "\n"
+        << "  " << std::left << std::setw(26) << "CSR (fwd + rev)" << std::right
+        << std::setw(12) << csrBuild << std::setw(12) << csrWalk << std::setw(12) << graph.memoryBytes() / 1048576.0 << "\n";
+    std::cout.unsetf(std::ios::floatfield);
+}
+
+// Heap bytes of a std::string beyond the object itself (0 when the text
+// fits in the small-string buffer).
+static size_t stringHeapBytes(const std::string& s) {
+    return s.capacity() > std::string().capacity() ? s.capacity() + 1 : 0;
+}
+
+// One object per course keyed by code, as the catalog was stored before
+// CourseTable.
+struct LegacyCourse {
+    std::string number;
+    std::string title;
+    std::vector<std::string> prereqs;
+};
+
+static void loadLegacy(const std::string& csv, std::unordered_map<std::string, LegacyCourse>& legacy) {
+    std::istringstream in(csv);
+    std::string line;
+    while (std::getline(in, line)) {
+        std::vector<std::string> f = splitCSV(line);
+        LegacyCourse c{ canonCode(f[0]), f[1], {} };
+        for (size_t i = 2; i < f.size(); ++i) c.prereqs.push_back(canonCode(f[i]));
+        std::string key = c.number;
+        legacy[key] = std::move(c);
+    }
+}
+
+// Legacy layout against the column layout. Sizes count container payloads
+// and estimated hash node overhead, not allocator headers.
+static void benchTable() {
+    const size_t courses = 1000000;
+    std::string csv = makeCatalogCSV(courses);
+    std::cout << "Course storage: " << courses << " courses\n";
+
+    std::unordered_map<std::string, LegacyCourse> legacy;
+    loadLegacy(csv, legacy);
+    size_t legacyBytes = legacy.bucket_count() * sizeof(void*);
+    for (const auto& kv : legacy) {
+        const LegacyCourse& c = kv.second;
+        legacyBytes += sizeof(kv) + 2 * sizeof(void*) + stringHeapBytes(kv.first) +
+            stringHeapBytes(c.number) + stringHeapBytes(c.title) +
+            c.prereqs.capacity() * sizeof(std::string);
+        for (const auto& p : c.prereqs) legacyBytes += stringHeapBytes(p);
+    }
+
+    Catalog catalog;
+    parseCourses(csv, catalog);
+    size_t tableBytes = catalog.memoryBytes();
+
+    size_t legacyHits = 0, tableHits = 0, legacyLen = 0, tableLen = 0;
+    double legacyScan = bestOfMs(3, [&] {
+        legacyLen = 0;
+        for (const auto& kv : legacy) legacyLen += kv.second.number.size() + kv.second.title.size();
+    });
+    double tableScan = bestOfMs(3, [&] {
+        tableLen = 0;
+        for (const Course& c : catalog) tableLen += catalog.code(c.id()).size() + c.title().size();
+    });
+    double legacyFilter = bestOfMs(3, [&] {
+        legacyHits = 0;
+        for (const auto& kv : legacy) legacyHits += kv.second.title.compare(0, 4, "Data") == 0;
+    });
+    double tableFilter = bestOfMs(3, [&] {
+        tableHits = 0;
+        for (const Course& c : catalog) tableHits += c.title().compare(0, 4, "Data") == 0;
+    });
+    if (legacyLen != tableLen || legacyHits != tableHits) std::cout << "  ! scan mismatch\n";
+
+    std::cout << std::fixed << std::setprecision(1)
+        << "  " << std::left << std::setw(26) << "layout" << std::right
+        << std::setw(12) << "bytes/course" << std::setw(12) << "scan ms" << std::setw(12) << "filter ms\n"
+        << "  " << std::left << std::setw(26) << "unordered_map<Course>" << std::right
+        << std::setw(12) << (double)legacyBytes / courses << std::setw(12) << legacyScan
+        << std::setw(12) << legacyFilter << "\n"
+        << "  " << std::left << std::setw(26) << "CourseTable" << std::right
+        << std::setw(12) << (double)tableBytes / courses << std::setw(12) << tableScan
+        << std::setw(12) << tableFilter << "\n";
+    std::cout.unsetf(std::ios::floatfield);
+}
+
+// Cost of throwing a loaded catalog away (what a reload pays first).
+static void benchReload() {
+    const size_t courses = 1000000;
+    std::string csv = makeCatalogCSV(courses);
+    std::cout << "Catalog teardown: " << courses << " courses\n";
+
+    std::unordered_map<std::string, LegacyCourse> legacy;
+    double legacyMs = 0, catalogMs = 0;
+    Catalog catalog;
+    for (int r = 0; r < 3; ++r) {
+        loadLegacy(csv, legacy);
+        legacyMs += bestOfMs(1, [&] { legacy.clear(); }) / 3;
+        parseCourses(csv, catalog);
+        catalogMs += bestOfMs(1, [&] { catalog.clear(); }) / 3;
+    }
+    std::cout << std::fixed << std::setprecision(2)
+        << "  " << std::left << std::setw(26) << "unordered_map<Course>" << std::right
+        << std::setw(10) << legacyMs << " ms\n"
+        << "  " << std::left << std::setw(26) << "Catalog (arena)" << std::right
+        << std::setw(10) << catalogMs << " ms\n";
+    std::cout.unsetf(std::ios::floatfield);
+}
+
+// canonCode as originally written: copy, stripBOM + trim erases, then the
+// locale-aware isalnum/toupper per byte.
+static std::string legacyCanonCode(std::string s) {
+    stripBOM(s);
+    trim(s);
+    std::string out;
+    out.reserve(s.size());
+    for (unsigned char ch : s) {
+        if (std::isalnum(ch)) out.push_back((char)std::toupper(ch));
+    }
+    return out;
+}
+
+static void benchCanon() {
+    const size_t count = 200000;
+    struct Case { const char* label; size_t width; };
+    const Case cases[] = { { "short codes", 0 }, { "long inputs", 96 } };
+
+    for (const Case& cs : cases) {
+        std::vector<std::string> inputs;
+        inputs.reserve(count);
+        size_t bytes = 0;
+        for (size_t i = 0; i < count; ++i) {
+            std::string s = (i % 3 == 0 ? " csci " : "MATH-") + std::to_string(100 + i % 900);
+            while (s.size() < cs.width) s += (i % 2) ? " sec-a/Lab " : "Section";
+            if (i % 7 == 0) s += "\t";
+            bytes += s.size();
+            inputs.push_back(std::move(s));
+        }
+        double mb = bytes / (1024.0 * 1024.0);
+        std::cout << "canonCode, " << cs.label << ": " << count << " inputs, "
+            << bytes / count << " bytes avg\n";
+
+        size_t expected = 0;
+        double baseMs = bestOfMs(5, [&] {
+            expected = 0;
+            for (const auto& s : inputs) expected += legacyCanonCode(s).size();
+        });
+        printBenchRow("legacy (locale)", baseMs, baseMs, mb);
+
+        size_t got = 0;
+        double ms = bestOfMs(5, [&] {
+            got = 0;
+            for (const auto& s : inputs) got += canonCode(s).size();
+        });
+        printBenchRow("canonCode (string)", ms, baseMs, mb);
+
+        std::vector<char> buf(cs.width + 64);
+        for (const auto& k : canon::kernels()) {
+            if (!k.supported) {
+                std::cout << "  " << std::left << std::setw(22) << ("into/" + std::string(k.name))
+                    << std::right << "  (not supported on this CPU)\n";
+                continue;
+            }
+            size_t total = 0;
+            double kms = bestOfMs(5, [&] {
+                total = 0;
+                for (const auto& s : inputs) total += k.fn(s.data(), s.size(), buf.data());
+            });
+            printBenchRow("into/" + std::string(k.name), kms, baseMs, mb);
+            if (total != expected) std::cout << "  ! length mismatch\n";
+        }
+        if (got != expected) std::cout << "  ! length mismatch\n";
+    }
+}
+
+// Code sets for the hash benchmark. "registrar" mimics real catalogs:
+// a few dozen department prefixes, 100-799 level numbers, and the odd
+// lab/honors suffix.
+static std::vector<std::string> makeCodeSet(const std::string& kind) {
+    std::vector<std::string> codes;
+    if (kind == "registrar") {
+        for (const char* d : kDepts)
+            for (int n = 100; n < 800; ++n) {
+                codes.push_back(d + std::to_string(n));
+                if (n % 10 == 1) codes.push_back(d + std::to_string(n) + "L");
+                if (n % 50 == 0) codes.push_back(d + std::to_string(n) + "H");
+            }
+    }
+    else if (kind == "sequential") {
+        for (int i = 0; i < 1000000; ++i) codes.push_back("CSCI" + std::to_string(100000 + i));
+    }
+    else {
+        Xorshift rng(99);
+        std::unordered_set<std::string> seen;
+        while (seen.size() < 500000) {
+            std::string c;
+            for (size_t len = 4 + rng() % 7; c.size() < len;) {
+                uint64_t r = rng() % 36;
+                c += (char)(r < 10 ? '0' + r : 'A' + (r - 10));
+            }
+            if (seen.insert(c).second) codes.push_back(c);
+        }
+    }
+    return codes;
+}
+
+// Chi-square of bucket counts over (bucket count) buckets, divided by the
+// bucket count: about 1.0 for a uniform hash, larger means clumping.
+template <class Hash>
+static double bucketChiSquare(const std::vector<std::string>& codes, Hash&& hash) {
+    size_t buckets = 1;
+    while (buckets < codes.size()) buckets *= 2;
+    std::vector<uint32_t> counts(buckets, 0);
+    for (const auto& c : codes) ++counts[hash(c) & (buckets - 1)];
+    double expected = (double)codes.size() / buckets, chi = 0;
+    for (uint32_t n : counts) chi += (n - expected) * (n - expected) / expected;
+    return chi / buckets;
+}
+
+static void benchHash() {
+    for (const char* kind : { "registrar", "sequential", "random" }) {
+        std::vector<std::string> codes = makeCodeSet(kind);
+        std::cout << "Course-code hashing, " << kind << ": " << codes.size() << " codes\n";
+
+        auto stdHash = [](const std::string& c) { return (uint64_t)std::hash<std::string_view>()(c); };
+        auto fnv = [](const std::string& c) { return snapshotHash(c); };
+        auto fast = [](const std::string& c) { return codeHash(c); };
+        auto row = [&](const char* name, auto&& hash) {
+            uint64_t sink = 0;
+            double ms = bestOfMs(5, [&] { for (const auto& c : codes) sink += hash(c); });
+            std::cout << "  " << std::left << std::setw(22) << name << std::right << std::fixed
+                << std::setprecision(2) << std::setw(8) << ms * 1e6 / codes.size() << " ns/hash"
+                << std::setw(10) << bucketChiSquare(codes, hash) << " chi2/bucket"
+                << (sink == 42 ? " " : "") << "\n";
+            std::cout.unsetf(std::ios::floatfield);
+        };
+        row("std::hash", stdHash);
+        row("FNV-1a", fnv);
+        row("codeHash", fast);
+
+        // Lookup throughput: the node-based map the catalog used to be,
+        // against the flat interner. Misses use codes with a suffix added.
+        std::unordered_map<std::string, CourseId> nodeMap;
+        CodeInterner flat;
+        for (const auto& c : codes) {
+            nodeMap.emplace(c, (CourseId)nodeMap.size());
+            flat.intern(c);
+        }
+        std::vector<std::string> probes(codes);
+        std::mt19937 rng(5);
+        std::shuffle(probes.begin(), probes.end(), rng);
+        std::vector<std::string> misses;
+        for (size_t i = 0; i < probes.size(); i += 4) misses.push_back(probes[i] + "X");
+
+        size_t hitA = 0, hitB = 0;
+        double mapHit = bestOfMs(3, [&] { hitA = 0; for (const auto& c : probes) hitA += nodeMap.count(c); });
+        double flatHit = bestOfMs(3, [&] {
+            hitB = 0;
+            for (const auto& c : probes) hitB += flat.find(c) != kNoCourse;
+        });
+        double mapMiss = bestOfMs(3, [&] { for (const auto& c : misses) hitA += nodeMap.count(c); });
+        double flatMiss = bestOfMs(3, [&] { for (const auto& c : misses) hitB += flat.find(c) != kNoCourse; });
+        if (hitA != hitB) std::cout << "  ! lookup mismatch\n";
+
+        CodeInterner::ProbeStats ps = flat.probeStats();
+        std::cout << std::fixed << std::setprecision(1)
+            << "  lookups (ns): unordered_map hit " << mapHit * 1e6 / probes.size()
+            << ", miss " << mapMiss * 1e6 / misses.size()
+            << " | flat hit " << flatHit * 1e6 / probes.size()
+            << ", miss " << flatMiss * 1e6 / misses.size()
+            << " | probe mean " << std::setprecision(2) << ps.mean << ", max " << ps.max << "\n";
+        std::cout.unsetf(std::ios::floatfield);
+    }
+}
+
+// Probe table against the frozen perfect hash: build cost, lookup latency
+// percentiles (timed in batches of 16 random lookups) and interner memory
+// (code buffer included). The registrar-sized set fits in cache; the 1M
+// set shows the cache-missing case.
+static void benchFreeze() {
+    for (const char* kind : { "registrar", "sequential" }) {
+        std::vector<std::string> codes = makeCodeSet(kind);
+        std::cout << "Frozen lookup, " << kind << ": " << codes.size() << " codes\n";
+
+        CodeInterner probing, frozen;
+        for (const auto& c : codes) {
+            probing.intern(c);
+            frozen.intern(c);
+        }
+        double buildMs = bestOfMs(1, [&] { frozen.freeze(); });
+
+        std::vector<std::string> probes;
+        std::mt19937 rng(11);
+        for (size_t i = 0; i < 2000000; ++i) probes.push_back(codes[rng() % codes.size()]);
+
+        auto lookups = [&](const CodeInterner& in) {
+            return measureLatency(probes.size(), 16, [&](size_t i) { return (size_t)(in.find(probes[i]) != kNoCourse); });
+        };
+        Latency a = lookups(probing), b = lookups(frozen);
+        if (a.results != b.results || a.results != probes.size()) std::cout << "  ! lookup mismatch\n";
+
+        std::cout << std::fixed << std::setprecision(1)
+            << "  perfect hash build: " << buildMs << " ms\n"
+            << "  " << std::left << std::setw(16) << "index" << std::right << std::setw(10) << "p50 ns"
+            << std::setw(10) << "p99 ns" << std::setw(10) << "p99.9 ns" << std::setw(14) << "bytes/code\n"
+            << "  " << std::left << std::setw(16) << "Robin Hood" << std::right << std::setw(10) << a.p50
+            << std::setw(10) << a.p99 << std::setw(10) << a.p999
+            << std::setw(14) << (double)probing.memoryBytes() / codes.size() << "\n"
+            << "  " << std::left << std::setw(16) << "perfect hash" << std::right << std::setw(10) << b.p50
+            << std::setw(10) << b.p99 << std::setw(10) << b.p999
+            << std::setw(14) << (double)frozen.memoryBytes() / codes.size() << "\n";
+        std::cout.unsetf(std::ios::floatfield);
+    }
+}
+
+// Building the full course listing: sort on every call (as printCourseList
+// used to) against walking the persistent order index. Also checks that
+// courses added after the load land in order.
+static void benchList() {
+    const size_t courses = 1000000;
+    std::string csv = makeCatalogCSV(courses);
+    Catalog catalog;
+    parseCourses(csv, catalog);
+    std::cout << "Course listing: " << catalog.size() << " courses\n";
+
+    std::string a, b;
+    double sortMs = bestOfMs(3, [&] {
+        std::vector<CourseId> ids;
+        for (const Course& c : catalog) ids.push_back(c.id());
+        std::sort(ids.begin(), ids.end(),
+            [&](CourseId x, CourseId y) { return naturalLess(catalog.code(x), catalog.code(y)); });
+        a.clear();
+        for (CourseId id : ids) a.append(catalog.code(id)).append(", ").append(catalog.find(id).title()).push_back('\n');
+    });
+    double walkMs = bestOfMs(3, [&] {
+        CourseCursor cursor(catalog);
+        b.clear();
+        cursor.next(catalog.size(), [&](Course c) {
+            b.append(catalog.code(c.id())).append(", ").append(c.title()).push_back('\n');
+        });
+    });
+    if (a != b) std::cout << "  ! listing mismatch\n";
+    double mb = a.size() / (1024.0 * 1024.0);
+    printBenchRow("sort per call", sortMs, sortMs, mb);
+    printBenchRow("order index walk", walkMs, sortMs, mb);
+
+    std::vector<CourseId> none;
+    for (int i = 0; i < 1000; ++i) {
+        CourseId id = catalog.intern(canonCode("ADD" + std::to_string(i * 7919 % 1000)));
+        catalog.put(id, "Added", { none.data(), none.data() });
+    }
+    for (size_t i = 1; i < catalog.size(); ++i) {
+        if (!naturalLess(catalog.code(catalog.ordered(i - 1).id()), catalog.code(catalog.ordered(i).id()))) {
+            std::cout << "  ! order index broken after put\n";
+            break;
+        }
+    }
+}
+
+// Ordering course codes: std::sort over an index against the MSD radix
+// sort, single-threaded and on the shared pool; then natural order with a
+// naturalLess comparator against the packed keys the catalog keeps (key
+// packing, done once at load, is timed separately). Codes are
+// registrar-like (department + number + optional suffix) in random order,
+// duplicates included, stored contiguously as the interner stores them.
+static void benchSort() {
+    for (size_t count : { (size_t)1000000, (size_t)10000000 }) {
+        std::string bytes;
+        std::vector<uint32_t> ends;
+        ends.reserve(count);
+        Xorshift rng(7);
+        for (size_t i = 0; i < count; ++i) {
+            bytes += makeCode(rng, 900000);
+            ends.push_back((uint32_t)bytes.size());
+        }
+        auto key = [&](uint32_t i) {
+            uint32_t b = i ? ends[i - 1] : 0;
+            return std::string_view(bytes.data() + b, ends[i] - b);
+        };
+        std::vector<uint32_t> base(count);
+        for (uint32_t i = 0; i < count; ++i) base[i] = i;
+        std::cout << "Code sort: " << count << " codes, " << ThreadPool::shared().size() << " threads\n";
+
+        std::vector<uint32_t> a, b, c;
+        double stdMs = bestOfMs(3, [&] {
+            a = base;
+            std::sort(a.begin(), a.end(), [&](uint32_t p, uint32_t q) { return key(p) < key(q); });
+        });
+        double seqMs = bestOfMs(3, [&] { b = base; radixSortByKey(b, key); });
+        double parMs = bestOfMs(3, [&] { c = base; radixSortByKey(c, key, &ThreadPool::shared()); });
+        for (size_t i = 0; i < count; ++i) {
+            if (key(a[i]) != key(b[i]) || key(a[i]) != key(c[i])) {
+                std::cout << "  ! order mismatch at " << i << "\n";
+                break;
+            }
+        }
+
+        std::vector<uint64_t> keys(count);
+        double packMs = bestOfMs(3, [&] { for (uint32_t i = 0; i < count; ++i) keys[i] = codeSortKey(key(i)); });
+        double natMs = bestOfMs(3, [&] {
+            a = base;
+            std::sort(a.begin(), a.end(), [&](uint32_t p, uint32_t q) { return naturalLess(key(p), key(q)); });
+        });
+        double packedMs = bestOfMs(3, [&] {
+            b = base;
+            radixSortByU64(b, [&](uint32_t i) { return keys[i]; }, &ThreadPool::shared());
+            for (size_t i = 0, j; i < count; i = j) {
+                for (j = i + 1; j < count && keys[b[j]] == keys[b[i]]; ++j) {}
+                if (j - i > 1)
+                    std::sort(b.begin() + i, b.begin() + j, [&](uint32_t p, uint32_t q) { return naturalLess(key(p), key(q)); });
+            }
+        });
+        for (size_t i = 0; i < count; ++i) {
+            if (key(a[i]) != key(b[i])) {
+                std::cout << "  ! natural order mismatch at " << i << "\n";
+                break;
+            }
+        }
+
+        double mb = bytes.size() / (1024.0 * 1024.0);
+        printBenchRow("std::sort", stdMs, stdMs, mb);
+        printBenchRow("radix, 1 thread", seqMs, stdMs, mb);
+        printBenchRow("radix, pool", parMs, stdMs, mb);
+        printBenchRow("natural, std::sort", natMs, natMs, mb);
+        printBenchRow("natural, packed keys", packedMs, natMs, mb);
+        printBenchRow("  (key packing)", packMs, natMs, mb);
+    }
+}
+
+// Range queries: scanning every course with CodeQuery::matches against
+// the two binary searches over the order index. 1M courses across 48
+// departments; each query is a level, a number range or a department.
+static void benchRange() {
+    const size_t courses = 1000000;
+    std::string csv;
+    for (size_t i = 0; i < courses; ++i)
+        csv.append(kDepts[i % kDeptCount]).append(std::to_string(100 + i / kDeptCount)).append(",Course ").append(std::to_string(i)).push_back('\n');
+    Catalog catalog;
+    parseCourses(csv, catalog);
+
+    std::vector<std::string> texts;
+    for (int i = 0; i < 200; ++i) {
+        std::string d = kDepts[i % kDeptCount];
+        int n = 100 + i * 271 % 20000;
+        if (i % 3 == 0) texts.push_back(d + std::to_string(n / 100) + "XX");
+        else if (i % 3 == 1) texts.push_back(d + std::to_string(n) + "-" + std::to_string(n + 40));
+        else texts.push_back(d);
+    }
+    std::vector<CodeQuery> queries(texts.size());
+    std::string error;
+    for (size_t i = 0; i < texts.size(); ++i) queries[i].parse(texts[i], error);
+    std::cout << "Range queries: " << catalog.size() << " courses, " << queries.size() << " queries\n";
+
+    size_t scanHits = 0, indexHits = 0;
+    double scanMs = bestOfMs(1, [&] {
+        scanHits = 0;
+        for (const CodeQuery& q : queries)
+            for (size_t i = 0; i < catalog.size(); ++i) scanHits += q.matches(catalog.code(catalog.ordered(i).id()));
+    });
+    double indexMs = bestOfMs(3, [&] {
+        indexHits = 0;
+        for (const CodeQuery& q : queries) {
+            auto r = q.candidates(catalog.size(), [&](size_t i) { return catalog.orderedKey(i); });
+            for (size_t i = r.first; i < r.second; ++i) indexHits += q.matches(catalog.code(catalog.ordered(i).id()));
+        }
+    });
+    if (scanHits != indexHits) std::cout << "  ! result mismatch\n";
+
+    std::cout << std::fixed << std::setprecision(1)
+        << "  full scan     " << std::setw(10) << scanMs * 1000 / queries.size() << " us/query\n"
+        << "  order index   " << std::setw(10) << indexMs * 1000 / queries.size() << " us/query ("
+        << (double)indexHits / queries.size() << " results/query)\n";
+    std::cout.unsetf(std::ios::floatfield);
+}
+
+// Top-10 completions of random partial codes (1-8 characters of a random
+// code): a sorted std::vector<std::string> with lower_bound against the
+// CodeCompleter, at 1M and 5M registrar-like codes. Latency is measured
+// per completion, timed in batches of 16 like --bench freeze.
+static void benchComplete() {
+    for (size_t count : { (size_t)1000000, (size_t)5000000 }) {
+        CodeInterner codes;
+        codes.reserve(count);
+        Xorshift rng(3);
+        while (codes.size() < count) codes.intern(makeCode(rng, 2000000));
+        auto codeAt = [&](uint32_t id) { return codes.name(id); };
+
+        std::vector<std::string> sorted;
+        double sortedBuild = bestOfMs(1, [&] {
+            sorted.clear();
+            for (uint32_t id = 0; id < count; ++id) sorted.emplace_back(codes.name(id));
+            std::sort(sorted.begin(), sorted.end());
+        });
+        CodeCompleter completer;
+        double trieBuild = bestOfMs(1, [&] {
+            std::vector<uint32_t> ids(count);
+            for (uint32_t id = 0; id < count; ++id) ids[id] = id;
+            completer.build(std::move(ids), codeAt, &ThreadPool::shared());
+        });
+
+        std::vector<std::string> prefixes;
+        for (size_t i = 0; i < 200000; ++i) {
+            std::string_view c = codes.name((uint32_t)(rng() % count));
+            prefixes.emplace_back(c.substr(0, 1 + rng() % std::min<size_t>(8, c.size())));
+        }
+
+        Latency a = measureLatency(prefixes.size(), 16, [&](size_t i) {
+            const std::string& p = prefixes[i];
+            size_t n = 0;
+            for (auto it = std::lower_bound(sorted.begin(), sorted.end(), p);
+                it != sorted.end() && n < kCompletions && it->compare(0, p.size(), p) == 0; ++it) ++n;
+            return n;
+        });
+        CompletionView view = completer.view();
+        Latency b = measureLatency(prefixes.size(), 16, [&](size_t i) {
+            return view.complete(prefixes[i], kCompletions, codeAt, [](uint32_t) {});
+        });
+        if (a.results != b.results) std::cout << "  ! result count mismatch\n";
+
+        std::cout << "Completion: " << count << " codes, top " << kCompletions << "\n"
+            << std::fixed << std::setprecision(1)
+            << "  " << std::left << std::setw(24) << "index" << std::right << std::setw(10) << "build ms"
+            << std::setw(10) << "p50 ns" << std::setw(10) << "p99 ns" << std::setw(14) << "bytes/code\n"
+            << "  " << std::left << std::setw(24) << "sorted vector<string>" << std::right << std::setw(10) << sortedBuild
+            << std::setw(10) << a.p50 << std::setw(10) << a.p99
+            << std::setw(14) << (double)sorted.capacity() * sizeof(std::string) / count << "\n"
+            << "  " << std::left << std::setw(24) << "CodeCompleter" << std::right << std::setw(10) << trieBuild
+            << std::setw(10) << b.p50 << std::setw(10) << b.p99
+            << std::setw(14) << (double)completer.memoryBytes() / count << "\n";
+        std::cout.unsetf(std::ios::floatfield);
+    }
+}
+
+// Title search: a scan that tokenizes every title per query against the
+// TitleIndex, over 200k and 1M titles of 2-7 words drawn with a skewed
+// distribution from a 6k-word vocabulary. Both rank the top 10 by BM25.
+static void benchTitles() {
+    static const char* common[] = { "introduction", "to", "systems", "operating", "data", "structures",
+        "advanced", "topics", "in", "calculus", "design", "analysis", "of", "and", "programming",
+        "networks", "theory", "principles", "applied", "methods", "organic", "chemistry", "history",
+        "american", "seminar", "laboratory", "research", "statistics", "linear", "algebra" };
+    const size_t kCommon = sizeof(common) / sizeof(common[0]);
+    Xorshift rng(11);
+    std::vector<std::string> vocab(common, common + kCommon);
+    while (vocab.size() < 6000) {
+        std::string w;
+        for (size_t len = 3 + rng() % 8; w.size() < len;) w += (char)('a' + rng() % 26);
+        vocab.push_back(w);
+    }
+
+    for (size_t count : { (size_t)200000, (size_t)1000000 }) {
+        std::vector<std::string> titles(count);
+        for (std::string& t : titles)
+            for (size_t k = 0, words = 2 + rng() % 6; k < words; ++k) {
+                double u = (double)(rng() % 1000000) / 1000000.0;
+                if (k) t += ' ';
+                t += vocab[(size_t)(u * u * u * vocab.size())];
+            }
+
+        TitleIndex index;
+        double build = bestOfMs(1, [&] {
+            index.build((uint32_t)count, [&](uint32_t d) { return std::string_view(titles[d]); }, &ThreadPool::shared());
+        });
+        TitleIndexView view = index.view();
+
+        // Queries are 1-3 words of a random title, plus "operating systems".
+        std::vector<std::string> queries{ "operating systems" };
+        while (queries.size() < 2000) {
+            const std::string& t = titles[rng() % count];
+            std::vector<std::string_view> words;
+            for (size_t i = 0, j; i < t.size(); i = j + 1) {
+                j = std::min(t.find(' ', i), t.size());
+                words.push_back(std::string_view(t).substr(i, j - i));
+            }
+            std::string q;
+            for (size_t k = 0, n = 1 + rng() % std::min<size_t>(3, words.size()); k < n; ++k)
+                q.append(k ? " " : "").append(words[rng() % words.size()]);
+            queries.push_back(q);
+        }
+
+        auto byId = [](uint32_t a, uint32_t b) { return a < b; };
+        auto indexed = [&](const std::string& q) {
+            std::vector<TitleIndexView::Hit> hits;
+            return view.search(q, kTitleResults, byId, hits);
+        };
+        auto scan = [&](const std::string& q) {
+            std::vector<std::string> terms;
+            std::string scratch;
+            titles::forEachTerm(q, scratch, [&](std::string_view w) { terms.emplace_back(w); });
+            std::vector<TitleIndexView::Hit> hits;
+            std::vector<std::string> words;
+            for (uint32_t d = 0; d < count; ++d) {
+                words.clear();
+                titles::forEachTerm(titles[d], scratch, [&](std::string_view w) { words.emplace_back(w); });
+                double score = 0;
+                bool all = !terms.empty();
+                for (size_t i = 0; all && i < terms.size(); ++i) {
+                    if (std::find(terms.begin(), terms.begin() + i, terms[i]) != terms.begin() + i) continue;
+                    uint32_t tf = (uint32_t)std::count(words.begin(), words.end(), terms[i]);
+                    all = tf > 0;
+                    if (all) score += view.bm25(view.idf(view.findTerm(terms[i])) * (titles::kK1 + 1.0), tf, d);
+                }
+                if (all) hits.push_back({ d, score });
+            }
+            size_t k = std::min(kTitleResults, hits.size());
+            std::partial_sort(hits.begin(), hits.begin() + k, hits.end(), [&](const auto& x, const auto& y) {
+                return x.score != y.score ? x.score > y.score : byId(x.doc, y.doc);
+            });
+            return hits.size();
+        };
+
+        // Whole queries, timed one at a time.
+        auto latency = [&](size_t n, auto&& one) {
+            return measureLatency(n, 1, [&](size_t i) { return one(queries[i]); });
+        };
+        const size_t scanned = 20;
+        Latency a = latency(scanned, scan);
+        Latency b = latency(queries.size(), indexed);
+        if (a.results != latency(scanned, indexed).results) std::cout << "  ! result count mismatch\n";
+
+        size_t titleBytes = 0;
+        for (const std::string& t : titles) titleBytes += t.size();
+        std::cout << std::fixed << std::setprecision(1) << "Title search: " << count << " titles ("
+            << titleBytes / 1024 << " KB), top " << kTitleResults << ", " << (double)b.results / queries.size()
+            << " matches/query on average\n"
+            << "  " << std::left << std::setw(24) << "method" << std::right << std::setw(10) << "build ms"
+            << std::setw(12) << "p50 us" << std::setw(12) << "p99 us" << std::setw(12) << "index MB\n"
+            << "  " << std::left << std::setw(24) << "scan titles" << std::right << std::setw(10) << 0.0
+            << std::setw(12) << a.p50 / 1000 << std::setw(12) << a.p99 / 1000 << std::setw(12) << 0.0 << "\n"
+            << "  " << std::left << std::setw(24) << "TitleIndex" << std::right << std::setw(10) << build
+            << std::setw(12) << b.p50 / 1000 << std::setw(12) << b.p99 / 1000
+            << std::setw(12) << index.memoryBytes() / 1048576.0 << "\n";
+        std::cout.unsetf(std::ios::floatfield);
+    }
+}
+
+// Typo lookup at 200k and 1M registrar-like codes: a scan with the
+// textbook DP distance, a scan with EditPattern (Myers), and the BK-tree.
+// Queries are codes with one or two typos (swapped, replaced, dropped or
+// doubled characters); every method must find the same matches.
+static void benchFuzzy() {
+    for (size_t count : { (size_t)200000, (size_t)1000000 }) {
+        CodeInterner codes;
+        codes.reserve(count);
+        Xorshift rng(5);
+        while (codes.size() < count) codes.intern(makeCode(rng, count * 2));
+        auto codeAt = [&](uint32_t id) { return codes.name(id); };
+        std::vector<uint32_t> ids(count);
+        for (uint32_t id = 0; id < count; ++id) ids[id] = id;
+
+        FuzzyIndex index;
+        double build = bestOfMs(1, [&] { index.build(ids, codeAt); });
+        FuzzyView view = index.view();
+
+        std::vector<std::string> queries;
+        while (queries.size() < 500) {
+            std::string q(codes.name((uint32_t)(rng() % count)));
+            for (size_t typos = 1 + rng() % 2; typos > 0; --typos) {
+                size_t at = rng() % (q.size() - 1);
+                switch (rng() % 4) {
+                case 0: std::swap(q[at], q[at + 1]); break;
+                case 1: q[at] = (char)('0' + rng() % 10); break;
+                case 2: q.erase(at, 1); break;
+                default: q.insert(at, 1, q[at]); break;
+                }
+            }
+            queries.push_back(q);
+        }
+
+        // Whole queries, timed one at a time.
+        auto latency = [&](size_t n, auto&& one) {
+            return measureLatency(n, 1, [&](size_t i) { return one(queries[i]); });
+        };
+        const size_t scanned = 20;
+        Latency dp = latency(scanned, [&](const std::string& q) {
+            size_t n = 0;
+            for (uint32_t id = 0; id < count; ++id) n += editDistance(q, codes.name(id)) <= fuzzyRadius(q);
+            return n;
+        });
+        Latency myers = latency(scanned, [&](const std::string& q) {
+            EditPattern pattern(q);
+            size_t n = 0;
+            for (uint32_t id = 0; id < count; ++id) n += pattern.distance(codes.name(id)) <= fuzzyRadius(q);
+            return n;
+        });
+        auto tree = [&](const std::string& q) {
+            size_t n = 0;
+            view.within(q, fuzzyRadius(q), [&](uint32_t, uint32_t) { ++n; });
+            return n;
+        };
+        Latency bk = latency(queries.size(), tree);
+        if (dp.results != myers.results || myers.results != latency(scanned, tree).results) std::cout << "  ! result count mismatch\n";
+
+        std::cout << std::fixed << std::setprecision(1) << "Fuzzy lookup: " << count << " codes, radius 1-2, "
+            << (double)bk.results / queries.size() << " matches/query on average\n"
+            << "  " << std::left << std::setw(24) << "method" << std::right << std::setw(10) << "build ms"
+            << std::setw(12) << "p50 us" << std::setw(12) << "p99 us" << std::setw(12) << "index MB\n";
+        auto row = [&](const char* name, double ms, const Latency& r, double mb) {
+            std::cout << "  " << std::left << std::setw(24) << name << std::right << std::setw(10) << ms
+                << std::setw(12) << r.p50 / 1000 << std::setw(12) << r.p99 / 1000 << std::setw(12) << mb << "\n";
+        };
+        row("scan, DP distance", 0.0, dp, 0.0);
+        row("scan, EditPattern", 0.0, myers, 0.0);
+        row("BK-tree (FuzzyIndex)", build, bk, index.memoryBytes() / 1048576.0);
+        std::cout.unsetf(std::ios::floatfield);
+    }
+}
+
+// Unlocks of a course at 200k and 1M courses: scanning every course's
+// prerequisite list (one pass per BFS level when transitive) against the
+// graph's forward rows, which collectUnlocks walks directly.
+static void benchUnlocks() {
+    for (uint32_t nodes : { 200000u, 1000000u }) {
+        auto edges = makeSyntheticDag(nodes, 7);
+        std::vector<std::vector<CourseId>> prereqs(nodes);
+        for (const auto& e : edges) prereqs[e.second].push_back(e.first);
+        CsrGraph graph;
+        double build = bestOfMs(1, [&] {
+            buildGraph(graph, nodes, edges);
+        });
+
+        Xorshift rng(11);
+        std::vector<CourseId> starts(200);
+        for (CourseId& s : starts) s = (CourseId)(rng() % nodes);
+
+        auto scan = [&](CourseId start, bool transitive) {
+            std::vector<uint32_t> depth(nodes, 0);
+            std::vector<bool> seen(nodes, false);
+            seen[start] = true;
+            size_t found = 0, added = 1;
+            for (uint32_t level = 1; added > 0 && (transitive || level == 1); ++level) {
+                added = 0;
+                for (CourseId v = 0; v < nodes; ++v) {
+                    if (seen[v]) continue;
+                    for (CourseId p : prereqs[v])
+                        if (seen[p] && (p == start ? level == 1 : depth[p] == level - 1)) {
+                            depth[v] = level;
+                            ++added;
+                            break;
+                        }
+                }
+                for (CourseId v = 0; v < nodes; ++v)
+                    if (depth[v] == level) seen[v] = true;
+                found += added;
+            }
+            return found;
+        };
+        auto indexed = [&](CourseId start, bool transitive) {
+            return collectUnlocks(start, nodes, transitive, [&](CourseId u) { return graph.successors(u); }).size();
+        };
+
+        auto latency = [&](size_t n, bool transitive, auto&& one) {
+            return measureLatency(n, 1, [&](size_t i) { return one(starts[i], transitive); });
+        };
+        const size_t scanned = 10;
+        Latency scanDirect = latency(scanned, false, scan);
+        Latency scanAll = latency(scanned, true, scan);
+        Latency csrDirect = latency(starts.size(), false, indexed);
+        Latency csrAll = latency(starts.size(), true, indexed);
+        if (scanDirect.results != latency(scanned, false, indexed).results ||
+            scanAll.results != latency(scanned, true, indexed).results)
+            std::cout << "  ! result count mismatch\n";
+
+        std::cout << std::fixed << std::setprecision(1) << "Unlocks: " << nodes << " courses, " << edges.size()
+            << " prerequisite edges, " << (double)csrDirect.results / starts.size() << " direct and " << (double)csrAll.results / starts.size()
+            << " transitive unlocks/query on average\n"
+            << "  " << std::left << std::setw(28) << "method" << std::right << std::setw(10) << "build ms"
+            << std::setw(12) << "p50 us" << std::setw(12) << "p99 us\n";
+        auto row = [&](const char* name, double ms, const Latency& r) {
+            std::cout << "  " << std::left << std::setw(28) << name << std::right << std::setw(10) << ms
+                << std::setw(12) << r.p50 / 1000 << std::setw(12) << r.p99 / 1000 << "\n";
+        };
+        row("scan prereqs, direct", 0.0, scanDirect);
+        row("scan prereqs, transitive", 0.0, scanAll);
+        row("CSR successors, direct", build, csrDirect);
+        row("CSR successors, transitive", build, csrAll);
+        std::cout.unsetf(std::ios::floatfield);
+    }
+}
+
+// "Is a required for v" on catalog-shaped DAGs of 20k, 100k and 1M courses
+// and a 20k random DAG (where most courses require most earlier ones): a
+// backward search over the prerequisite rows against the closure's bit
+// test, dense where the matrix fits and compressed otherwise (both at 20k).
+static void benchClosure() {
+    const DagShape catalogShape = { "5 levels, fan-in 3", 5, 3 }, randomShape = { "random DAG", 0, 0 };
+    const std::pair<uint32_t, DagShape> runs[] = { { 20000, catalogShape }, { 100000, catalogShape },
+        { 1000000, catalogShape }, { 20000, randomShape } };
+    for (const auto& run : runs) {
+        const uint32_t nodes = run.first;
+        const DagShape& shape = run.second;
+        auto edges = makeDag(nodes, shape, 9);
+        CsrGraph graph;
+        buildGraph(graph, nodes, edges);
+        auto successors = [&](CourseId u) { return graph.successors(u); };
+
+        auto queries = makeReachQueries(graph, 20000);
+        PrereqSearch search(graph);
+        const size_t searched = 2000;
+        size_t yes = 0;
+        double searchNs = bestOfMs(1, [&] {
+            for (size_t i = 0; i < searched; ++i) yes += search(queries[i].first, queries[i].second);
+        }) * 1e6 / searched;
+
+        std::cout << std::fixed << std::setprecision(1) << "Closure: " << nodes << (shape.levels ? " courses, " : " courses (random DAG), ") << edges.size()
+            << " prerequisite edges, " << 100.0 * yes / searched << "% of pairs related\n"
+            << "  " << std::left << std::setw(26) << "method" << std::right << std::setw(12) << "build ms"
+            << std::setw(12) << "ns/query" << std::setw(12) << "MB\n"
+            << "  " << std::left << std::setw(26) << "search prerequisites" << std::right << std::setw(12) << 0.0
+            << std::setw(12) << searchNs << std::setw(12) << 0.0 << "\n";
+
+        std::vector<size_t> limits{ closure::kLimitBytes };
+        if (nodes <= 20000) limits.push_back((size_t)nodes * nodes / 8 / 2);
+        for (size_t limit : limits) {
+            TransitiveClosure tc;
+            bool built = false;
+            double build = bestOfMs(1, [&] { built = tc.build(nodes, successors, limit); });
+            if (!built) {
+                std::cout << "  " << std::left << std::setw(26) << "closure" << std::right << std::setw(12) << build
+                    << std::setw(12) << "-" << std::setw(12) << "-" << "  (over the limit)\n";
+                continue;
+            }
+            size_t hits = 0;
+            double ns = bestOfMs(3, [&] {
+                hits = 0;
+                for (const auto& q : queries) hits += tc.reaches(q.first, q.second);
+            }) * 1e6 / queries.size();
+            size_t yesClosure = 0;
+            for (size_t i = 0; i < searched; ++i) yesClosure += tc.reaches(queries[i].first, queries[i].second);
+            if (yesClosure != yes || hits == 0) std::cout << "  ! result mismatch\n";
+            std::cout << "  " << std::left << std::setw(26) << (tc.dense() ? "closure, dense" : "closure, compressed")
+                << std::right << std::setw(12) << build << std::setw(12) << ns
+                << std::setw(12) << tc.memoryBytes() / 1048576.0 << "\n";
+        }
+        std::cout.unsetf(std::ios::floatfield);
+    }
+}
+
+// Reachability labels on million-course catalogs, shallow to deep and
+// sparse to dense, and a random DAG: build time, memory and query time
+// against the plain search, and how many queries the labels settle
+// without searching.
+static void benchReach() {
+    const DagShape shapes[] = { { "2 levels, fan-in 1", 2, 1 }, { "5 levels, fan-in 3", 5, 3 }, { "10 levels, fan-in 3", 10, 3 },
+        { "20 levels, fan-in 6", 20, 6 }, { "random DAG", 0, 0 } };
+    const uint32_t nodes = 1000000;
+    std::cout << std::fixed << std::setprecision(1) << "Reachability labels: " << nodes << " courses, 20000 queries per shape\n"
+        << "  " << std::left << std::setw(22) << "shape" << std::right << std::setw(10) << "edges" << std::setw(10) << "related"
+        << std::setw(10) << "build ms" << std::setw(8) << "MB" << std::setw(12) << "labels ns" << std::setw(12) << "search ns"
+        << std::setw(11) << "no search\n";
+    for (const DagShape& shape : shapes) {
+        auto edges = makeDag(nodes, shape, 11);
+        CsrGraph graph;
+        buildGraph(graph, nodes, edges);
+        auto queries = makeReachQueries(graph, 20000);
+
+        ReachLabels labels;
+        double build = bestOfMs(1, [&] { labels.build(nodes, [&](CourseId u) { return graph.successors(u); }); });
+        const ReachView view = labels.view();
+        ReachScratch scratch;
+        size_t hits = 0;
+        double labelNs = bestOfMs(3, [&] {
+            hits = 0;
+            for (const auto& q : queries) hits += view.reaches(q.first, q.second, scratch);
+        }) * 1e6 / queries.size();
+        size_t settled = 0;
+        for (const auto& q : queries) {
+            const uint32_t a = view.component[q.first], v = view.component[q.second];
+            settled += a == v || !view.mayReach(a, v) || view.treeReach(a, v);
+        }
+
+        PrereqSearch search(graph);
+        const size_t searched = 2000;
+        size_t yes = 0, yesLabels = 0;
+        double searchNs = bestOfMs(1, [&] {
+            for (size_t i = 0; i < searched; ++i) yes += search(queries[i].first, queries[i].second);
+        }) * 1e6 / searched;
+        for (size_t i = 0; i < searched; ++i) yesLabels += view.reaches(queries[i].first, queries[i].second, scratch);
+
+        std::cout << "  " << std::left << std::setw(22) << shape.name << std::right << std::setw(10) << edges.size()
+            << std::setw(9) << 100.0 * hits / queries.size() << "%" << std::setw(10) << build
+            << std::setw(8) << labels.memoryBytes() / 1048576.0 << std::setw(12) << labelNs << std::setw(12) << searchNs
+            << std::setw(9) << 100.0 * settled / queries.size() << "%\n";
+        if (yesLabels != yes || hits == 0) std::cout << "  ! result mismatch\n";
+    }
+    std::cout.unsetf(std::ios::floatfield);
+}
+
+// Catalog edits on million-course catalogs: random prerequisite adds
+// (within a department and across) and removals, each repairing the
+// kept order, against recomputing the order from scratch per edit. The
+// second table runs the same edits on a patched graph and repairs the
+// recommended (smallest code first) order, against a fresh heap Kahn.
+static void benchTopo() {
+    const DagShape shapes[] = { { "5 levels, fan-in 3", 5, 3 }, { "20 levels, fan-in 6", 20, 6 } };
+    const uint32_t nodes = 1000000, edits = 20000;
+    std::cout << std::fixed << std::setprecision(1) << "Incremental order: " << nodes << " courses, " << edits << " edits per shape\n"
+        << "  " << std::left << std::setw(22) << "shape" << std::right << std::setw(10) << "build ms" << std::setw(10) << "added"
+        << std::setw(10) << "rejected" << std::setw(10) << "removed" << std::setw(10) << "moved" << std::setw(10) << "us/edit"
+        << std::setw(15) << "recompute ms\n";
+    for (const DagShape& shape : shapes) {
+        auto edges = makeCatalogDag(nodes, shape.levels, shape.fanIn, 13);
+        DynamicTopoOrder topo;
+        double build = bestOfMs(1, [&] {
+            topo.build(nodes, [&](auto&& emit) { for (const auto& e : edges) emit(e.first, e.second); },
+                [](uint32_t u) { return u; });
+        });
+
+        Xorshift rng(29);
+        size_t added = 0, rejected = 0, removed = 0, moved = 0;
+        double ms = bestOfMs(1, [&] {
+            for (uint32_t i = 0; i < edits; ++i) {
+                if (rng() % 4 == 0) {
+                    const auto& e = edges[rng() % edges.size()];
+                    removed += topo.removeEdge(e.first, e.second);
+                    continue;
+                }
+                const uint32_t v = (uint32_t)(rng() % nodes);
+                const uint32_t u = rng() % 2 ? v - v % 200 + (uint32_t)(rng() % 200) : (uint32_t)(rng() % nodes);
+                if (topo.addEdge(u, v)) {
+                    ++added;
+                    moved += topo.lastMoved();
+                }
+                else ++rejected;
+            }
+        });
+
+        // One full recompute, for comparison: CSR build and Kahn.
+        double recompute = bestOfMs(1, [&] {
+            CsrGraph graph;
+            graph.build(nodes, [&](auto&& emit) {
+                for (uint32_t u = 0; u < nodes; ++u)
+                    for (uint32_t v : topo.successors(u)) emit(u, v);
+            });
+            std::vector<uint32_t> indegree(nodes);
+            for (uint32_t u = 0; u < nodes; ++u) indegree[u] = graph.indegree(u);
+            kahnCount(nodes, std::move(indegree), [&](CourseId u) { return graph.successors(u); });
+        });
+
+        bool ordered = topo.size() == nodes;
+        for (uint32_t u = 0; u < nodes && ordered; ++u)
+            for (uint32_t v : topo.successors(u)) ordered = ordered && topo.position(u) < topo.position(v);
+        std::cout << "  " << std::left << std::setw(22) << shape.name << std::right << std::setw(10) << build
+            << std::setw(10) << added << std::setw(10) << rejected << std::setw(10) << removed
+            << std::setw(10) << (added ? (double)moved / added : 0.0) << std::setw(10) << ms * 1000.0 / edits
+            << std::setw(14) << recompute << "\n";
+        if (!ordered || rejected == 0) std::cout << "  ! result mismatch\n";
+    }
+
+    const uint32_t rankedEdits = 2000;
+    std::cout << "Recommended order: " << nodes << " courses, " << rankedEdits << " edits per shape\n"
+        << "  " << std::left << std::setw(22) << "shape" << std::right << std::setw(10) << "build ms"
+        << std::setw(10) << "window" << std::setw(10) << "us/edit" << std::setw(12) << "resort ms\n";
+    for (const DagShape& shape : shapes) {
+        auto edges = makeCatalogDag(nodes, shape.levels, shape.fanIn, 13);
+        CsrGraph graph;
+        buildGraph(graph, nodes, edges);
+        DynamicTopoOrder topo;  // rejects the edges that would close a cycle, as in the catalog
+        topo.build(nodes, [&](auto&& emit) { for (const auto& e : edges) emit(e.first, e.second); },
+            [](uint32_t u) { return u; });
+        auto ready = [](uint32_t) { return true; };
+        auto successors = [&](uint32_t u) { return graph.successors(u); };
+        auto predecessors = [&](uint32_t u) { return graph.predecessors(u); };
+        auto less = [](uint32_t a, uint32_t b) { return a < b; };
+        RankedTopoOrder ranked;
+        double build = bestOfMs(1, [&] {
+            ranked.build(nodes, ready, [&](uint32_t u) { return graph.indegree(u); }, successors,
+                [](uint32_t u) { return u; });
+        });
+
+        Xorshift rng(31);
+        size_t window = 0, repaired = 0;
+        std::vector<uint32_t> touched(1);
+        double ms = bestOfMs(1, [&] {
+            for (uint32_t i = 0; i < rankedEdits; ++i) {
+                if (rng() % 4 == 0) {
+                    const auto& e = edges[rng() % edges.size()];
+                    if (!topo.removeEdge(e.first, e.second)) continue;
+                    graph.removeEdge(e.first, e.second);
+                    touched[0] = e.second;
+                }
+                else {
+                    const uint32_t v = (uint32_t)(rng() % nodes);
+                    const uint32_t u = rng() % 2 ? v - v % 200 + (uint32_t)(rng() % 200) : (uint32_t)(rng() % nodes);
+                    if (!topo.addEdge(u, v)) continue;
+                    graph.addEdge(u, v);
+                    touched[0] = v;
+                }
+                ranked.repair(nodes, touched, ready, predecessors, successors, less);
+                window += ranked.lastWindow();
+                ++repaired;
+            }
+        });
+
+        std::vector<uint32_t> fresh;
+        double resort = bestOfMs(1, [&] {
+            std::vector<uint32_t> indegree(nodes);
+            for (uint32_t u = 0; u < nodes; ++u) indegree[u] = graph.indegree(u);
+            DaryHeap<4> frontier;
+            fresh.clear();
+            kahnSort(frontier, nodes, ready, indegree, successors, [](uint32_t u) { return (uint64_t)u; }, fresh);
+        });
+        std::cout << "  " << std::left << std::setw(22) << shape.name << std::right << std::setw(10) << build
+            << std::setw(10) << (repaired ? (double)window / repaired : 0.0) << std::setw(10) << ms * 1000.0 / repaired
+            << std::setw(11) << resort << "\n";
+        if (!ranked.valid() || ranked.order() != fresh) std::cout << "  ! result mismatch\n";
+    }
+    std::cout.unsetf(std::ios::floatfield);
+}
+
+// Ordering million-course graphs: the serial Kahn passes (heap frontier,
+// as the recommended order uses, and FIFO) against the level-by-level
+// sort on 1 to 8 threads, with and without sorting each level.
+static void benchLevels() {
+    const DagShape shapes[] = { { "5 levels, fan-in 3", 5, 3 }, { "20 levels, fan-in 6", 20, 6 }, { "random DAG", 0, 0 } };
+    const uint32_t nodes = 1000000;
+    for (const DagShape& shape : shapes) {
+        auto edges = makeDag(nodes, shape, 17);
+        CsrGraph graph;
+        buildGraph(graph, nodes, edges);
+        auto indegreeOf = [&](CourseId v) { return graph.indegree(v); };
+        auto successors = [&](CourseId u) { return graph.successors(u); };
+        std::vector<uint32_t> indegree(nodes);
+        for (CourseId v = 0; v < nodes; ++v) indegree[v] = graph.indegree(v);
+
+        size_t heapOut = 0;
+        double heapMs = bestOfMs(3, [&] {
+            std::vector<uint32_t> remaining = indegree;
+            std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<uint32_t>> zero;
+            for (CourseId v = 0; v < nodes; ++v)
+                if (remaining[v] == 0) zero.push(v);
+            for (heapOut = 0; !zero.empty(); ++heapOut) {
+                const CourseId u = zero.top();
+                zero.pop();
+                for (CourseId v : graph.successors(u))
+                    if (--remaining[v] == 0) zero.push(v);
+            }
+        });
+        size_t fifoOut = 0;
+        double fifoMs = bestOfMs(3, [&] { fifoOut = kahnCount(nodes, indegree, successors); });
+
+        LevelOrder reference;
+        reference.build(nodes, indegreeOf, successors);
+        reference.sortLevels([](CourseId u) { return u; });
+        std::cout << std::fixed << std::setprecision(1) << "Level sort: " << nodes << " courses (" << shape.name << "), "
+            << edges.size() << " edges, " << reference.levels() << " levels, " << ThreadPool::shared().size()
+            << " hardware threads\n"
+            << "  " << std::left << std::setw(26) << "method" << std::right << std::setw(12) << "ms"
+            << std::setw(14) << "sorted ms\n"
+            << "  " << std::left << std::setw(26) << "Kahn, heap frontier" << std::right << std::setw(12) << heapMs
+            << std::setw(13) << "-" << "\n"
+            << "  " << std::left << std::setw(26) << "Kahn, FIFO frontier" << std::right << std::setw(12) << fifoMs
+            << std::setw(13) << "-" << "\n";
+
+        bool ok = heapOut == nodes && fifoOut == nodes && reference.size() == nodes;
+        for (CourseId u = 0; u < nodes && ok; ++u)
+            for (CourseId v : graph.successors(u)) ok = ok && reference.level(u) < reference.level(v);
+        for (unsigned threads : { 1u, 2u, 4u, 8u }) {
+            ThreadPool pool(threads);
+            ThreadPool* use = threads > 1 ? &pool : nullptr;
+            LevelOrder levels;
+            double ms = bestOfMs(3, [&] { levels.build(nodes, indegreeOf, successors, use); });
+            double sortedMs = bestOfMs(3, [&] {
+                levels.build(nodes, indegreeOf, successors, use);
+                levels.sortLevels([](CourseId u) { return u; }, use);
+            });
+            ok = ok && levels.order() == reference.order() && levels.levelStart() == reference.levelStart();
+            std::cout << "  " << std::left << std::setw(26) << "by level, " + std::to_string(threads) + (threads == 1 ? " thread" : " threads")
+                << std::right << std::setw(12) << ms << std::setw(13) << sortedMs << "\n";
+        }
+        if (!ok) std::cout << "  ! result mismatch\n";
+        std::cout.unsetf(std::ios::floatfield);
+    }
+}
+
+// Kahn's algorithm on million-course graphs with each frontier: what the
+// frontier costs over the plain edge walk (the FIFO, which does no
+// ordering), starting from the original std::set of code strings.
+static void benchFrontier() {
+    const DagShape shapes[] = { { "5 levels, fan-in 3", 5, 3 }, { "random DAG", 0, 0 } };
+    const uint32_t nodes = 1000000;
+    std::vector<std::string> names(nodes);
+    for (uint32_t v = 0; v < nodes; ++v) names[v] = "C" + std::to_string(v);
+    std::vector<uint32_t> rank(nodes), byName(nodes);
+    for (uint32_t v = 0; v < nodes; ++v) byName[v] = v;
+    std::sort(byName.begin(), byName.end(), [&](uint32_t a, uint32_t b) { return names[a] < names[b]; });
+    for (uint32_t i = 0; i < nodes; ++i) rank[byName[i]] = i;
+    std::unordered_map<std::string, CourseId> idOf;
+    for (CourseId v = 0; v < nodes; ++v) idOf.emplace(names[v], v);
+    auto all = [](CourseId) { return true; };
+    auto byRank = [&](CourseId u) { return (uint64_t)rank[u]; };
+
+    for (const DagShape& shape : shapes) {
+        auto edges = makeDag(nodes, shape, 19);
+        CsrGraph graph;
+        buildGraph(graph, nodes, edges);
+        auto successors = [&](CourseId u) { return graph.successors(u); };
+        std::vector<uint32_t> indegree(nodes), remaining;
+        for (CourseId v = 0; v < nodes; ++v) indegree[v] = graph.indegree(v);
+        LevelOrder levels;
+        levels.build(nodes, [&](CourseId v) { return indegree[v]; }, successors);
+
+        struct Row { std::string name; double ms; };
+        std::vector<Row> rows;
+        std::vector<uint32_t> order, expected;
+        bool ok = true;
+        auto run = [&](const std::string& name, auto&& sort) {
+            double ms = bestOfMs(3, [&] {
+                remaining = indegree;
+                order.clear();
+                sort();
+            });
+            ok = ok && order.size() == nodes;
+            rows.push_back({ name, ms });
+        };
+
+        run("FIFO (no ordering)", [&] {
+            FifoFrontier f;
+            kahnSort(f, nodes, all, remaining, successors, byRank, order);
+        });
+        run("std::set<std::string>", [&] {
+            std::set<std::string> ready;
+            for (CourseId v = 0; v < nodes; ++v)
+                if (remaining[v] == 0) ready.insert(names[v]);
+            while (!ready.empty()) {
+                const CourseId u = idOf[*ready.begin()];
+                ready.erase(ready.begin());
+                order.push_back(u);
+                for (CourseId v : graph.successors(u))
+                    if (--remaining[v] == 0) ready.insert(names[v]);
+            }
+        });
+        expected = order;
+        run("priority_queue<rank>", [&] {
+            std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<uint32_t>> ready;
+            for (CourseId v = 0; v < nodes; ++v)
+                if (remaining[v] == 0) ready.push(rank[v]);
+            while (!ready.empty()) {
+                const CourseId u = byName[ready.top()];
+                ready.pop();
+                order.push_back(u);
+                for (CourseId v : graph.successors(u))
+                    if (--remaining[v] == 0) ready.push(rank[v]);
+            }
+        });
+        ok = ok && order == expected;
+        run("2-ary heap, code", [&] {
+            DaryHeap<2> f;
+            kahnSort(f, nodes, all, remaining, successors, byRank, order);
+        });
+        ok = ok && order == expected;
+        run("4-ary heap, code", [&] {
+            DaryHeap<4> f;
+            kahnSort(f, nodes, all, remaining, successors, byRank, order);
+        });
+        ok = ok && order == expected;
+        run("8-ary heap, code", [&] {
+            DaryHeap<8> f;
+            kahnSort(f, nodes, all, remaining, successors, byRank, order);
+        });
+        ok = ok && order == expected;
+        run("4-ary heap, unlocks", [&] {
+            DaryHeap<4> f;
+            kahnSort(f, nodes, all, remaining, successors,
+                [&](CourseId u) { return (uint64_t)(UINT32_MAX - graph.outdegree(u)) << 32 | rank[u]; }, order);
+        });
+        // Levels computed beforehand; the level pass itself is in --bench levels.
+        run("bucket queue, level", [&] {
+            BucketQueue f;
+            kahnSort(f, nodes, all, remaining, successors,
+                [&](CourseId u) { return (uint64_t)levels.level(u) << 32 | rank[u]; }, order);
+        });
+        levels.sortLevels([&](CourseId u) { return rank[u]; });
+        ok = ok && order == levels.order();
+
+        const double walkMs = rows.front().ms;
+        std::cout << std::fixed << std::setprecision(1) << "Kahn frontiers: " << nodes << " courses (" << shape.name << "), "
+            << edges.size() << " edges\n"
+            << "  " << std::left << std::setw(26) << "frontier" << std::right << std::setw(12) << "ms"
+            << std::setw(13) << "frontier %\n";
+        for (const Row& row : rows)
+            std::cout << "  " << std::left << std::setw(26) << row.name << std::right << std::setw(12) << row.ms
+                << std::setw(11) << std::max(0.0, 100.0 * (row.ms - walkMs) / row.ms) << "%\n";
+        if (!ok) std::cout << "  ! result mismatch\n";
+        std::cout.unsetf(std::ios::floatfield);
+    }
+}
+
+bool runBenchmark(const std::string& name) {
+    if (name == "splitcsv") benchSplitCSV();
+    else if (name == "graph") benchGraph();
+    else if (name == "table") benchTable();
+    else if (name == "reload") benchReload();
+    else if (name == "canon") benchCanon();
+    else if (name == "hash") benchHash();
+    else if (name == "freeze") benchFreeze();
+    else if (name == "list") benchList();
+    else if (name == "sort") benchSort();
+    else if (name == "range") benchRange();
+    else if (name == "complete") benchComplete();
+    else if (name == "titles") benchTitles();
+    else if (name == "fuzzy") benchFuzzy();
+    else if (name == "unlocks") benchUnlocks();
+    else if (name == "closure") benchClosure();
+    else if (name == "reach") benchReach();
+    else if (name == "topo") benchTopo();
+    else if (name == "levels") benchLevels();
+    else if (name == "frontier") benchFrontier();
+    else {
+        std::cout << "Unknown benchmark '" << name << "'. Available: splitcsv, graph, table, reload, canon, hash, freeze, list, sort, range, complete, titles, fuzzy, unlocks, closure, reach, topo, levels, frontier\n";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,205 @@
+﻿// Bench.h
+// CS499 – Final ePortfolio Artifact (Advising Assistance Program)
+//
+// Description:
+// What the benchmarks (Bench.cpp, --bench NAME) and the self-tests
+// (Tests.cpp, --test NAME) share: a seeded generator, synthetic catalogs,
+// course codes and prerequisite graphs, and a plain backward search to
+// check the reachability indexes against. Every workload is built from a
+// fixed seed, so a run repeats exactly.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "CsrGraph.h"
+#include "Interner.h"
+
+// Runs the named benchmark; false if there is none by that name.
+bool runBenchmark(const std::string& name);
+
+// Runs the named self-test, or every one for "all"; false if one fails or
+// there is none by that name.
+bool runTests(const std::string& name);
+
+// xorshift64: cheap, and the same sequence on every platform for a seed
+// (which must not be 0).
+class Xorshift {
+private:
+    uint64_t x_;
+
+public:
+    explicit Xorshift(uint64_t seed) : x_(seed) {}
+
+    uint64_t operator()() {
+        x_ ^= x_ << 13;
+        x_ ^= x_ >> 7;
+        x_ ^= x_ << 17;
+        return x_;
+    }
+};
+
+// Department prefixes of a registrar-like catalog.
+static const char* const kDepts[] = { "ACCT", "ANTH", "ARTH", "ASTR", "BIOL", "BUSN", "CHEM", "CHIN",
+    "CIVE", "COMM", "CSCI", "CS", "DANC", "ECON", "EDUC", "EE", "ENGL", "ENGR", "ENVS", "FIN",
+    "FREN", "GEOG", "GEOL", "GERM", "HIST", "HLTH", "IT", "ITAL", "JOUR", "KINE", "LATN", "LING",
+    "MATH", "ME", "MGMT", "MKTG", "MUSC", "NURS", "PHIL", "PHYS", "POLS", "PSYC", "RELI", "SOCI",
+    "SPAN", "STAT", "THEA", "WRIT" };
+static const size_t kDeptCount = sizeof(kDepts) / sizeof(kDepts[0]);
+
+// A random registrar-like code: a department, a number in
+// [100, 100 + numbers) and, one time in eight, a lab or honors suffix.
+static inline std::string makeCode(Xorshift& rng, uint64_t numbers) {
+    std::string code = kDepts[rng() % kDeptCount];
+    code += std::to_string(100 + rng() % numbers);
+    if (rng() % 8 == 0) code += "LH"[rng() % 2];
+    return code;
+}
+
+// Wide rows: code, title and many prerequisite columns with stray spaces.
+static inline std::string makeWideCSV(size_t rows, size_t prereqCols) {
+    std::string out;
+    out.reserve(rows * (24 + prereqCols * 10));
+    for (size_t r = 0; r < rows; ++r) {
+        out += "CSCI" + std::to_string(1000 + r % 9000) + ", Course Title " + std::to_string(r);
+        for (size_t p = 0; p < prereqCols; ++p) {
+            out += (p % 3 == 0) ? ", " : ",";
+            out += "MATH" + std::to_string(100 + (r * 7 + p) % 900);
+        }
+        out += "\r\n";
+    }
+    return out;
+}
+
+// Synthetic catalog CSV: unique codes, up to three earlier prerequisites.
+static inline std::string makeCatalogCSV(size_t courses) {
+    std::string csv;
+    csv.reserve(courses * 64);
+    Xorshift rng(7);
+    for (size_t i = 0; i < courses; ++i) {
+        csv += "CSCI" + std::to_string(100000 + i) + ",";
+        csv += (i % 4 == 0) ? "Data Structures " : "Software Design ";
+        csv += std::to_string(i);
+        for (uint64_t k = rng() % 4; k > 0 && i > 0; --k) csv += ",CSCI" + std::to_string(100000 + rng() % i);
+        csv += "\n";
+    }
+    return csv;
+}
+
+// Levenshtein distance by the textbook dynamic program, one row at a time.
+static inline uint32_t editDistance(std::string_view a, std::string_view b) {
+    std::vector<uint32_t> row(a.size() + 1);
+    for (size_t i = 0; i <= a.size(); ++i) row[i] = (uint32_t)i;
+    for (size_t j = 1; j <= b.size(); ++j) {
+        uint32_t diag = row[0];
+        row[0] = (uint32_t)j;
+        for (size_t i = 1; i <= a.size(); ++i) {
+            uint32_t up = row[i];
+            row[i] = std::min({ row[i] + 1, row[i - 1] + 1, diag + (a[i - 1] != b[j - 1]) });
+            diag = up;
+        }
+    }
+    return row[a.size()];
+}
+
+// Prerequisite edges (prerequisite, course) of a synthetic graph.
+using EdgeList = std::vector<std::pair<CourseId, CourseId>>;
+
+// Synthetic DAG: node i requires up to four random earlier nodes.
+static inline EdgeList makeSyntheticDag(uint32_t nodes, uint32_t seed) {
+    EdgeList edges;
+    edges.reserve((size_t)nodes * 2);
+    Xorshift rng(seed);
+    for (uint32_t v = 1; v < nodes; ++v) {
+        uint32_t k = (uint32_t)(rng() % 5);
+        for (uint32_t j = 0; j < k; ++j) edges.emplace_back((CourseId)(rng() % v), v);
+    }
+    return edges;
+}
+
+// Catalog-shaped DAG: departments of 200 consecutive courses split into
+// levels; a course requires up to fanIn courses of lower levels in its
+// department and, one time in eight, an introductory course of another.
+static inline EdgeList makeCatalogDag(uint32_t nodes, uint32_t levels, uint32_t fanIn, uint32_t seed) {
+    const uint32_t dept = 200, perLevel = dept / levels;
+    EdgeList edges;
+    Xorshift rng(seed);
+    for (uint32_t v = 0; v < nodes; ++v) {
+        const uint32_t base = v - v % dept, below = (v - base) / perLevel * perLevel;
+        if (below == 0) continue;
+        for (uint32_t j = 0, k = 1 + (uint32_t)(rng() % fanIn); j < k; ++j)
+            edges.emplace_back((CourseId)(base + rng() % below), v);
+        if (rng() % 8 == 0 && nodes > dept) {
+            uint32_t other = (uint32_t)(rng() % (nodes / dept)) * dept;
+            if (other != base) edges.emplace_back((CourseId)(other + rng() % perLevel), v);
+        }
+    }
+    return edges;
+}
+
+// A graph to run on: catalog-shaped with the given levels and fan-in, or
+// the random DAG when levels is 0.
+struct DagShape {
+    const char* name;
+    uint32_t levels, fanIn;
+};
+
+static inline EdgeList makeDag(uint32_t nodes, const DagShape& shape, uint32_t seed) {
+    return shape.levels ? makeCatalogDag(nodes, shape.levels, shape.fanIn, seed) : makeSyntheticDag(nodes, seed);
+}
+
+static inline void buildGraph(CsrGraph& graph, uint32_t nodes, const EdgeList& edges) {
+    graph.build(nodes, [&](auto&& emit) { for (const auto& e : edges) emit(e.first, e.second); });
+}
+
+// "Is a required for v?" pairs over a graph: half are a course and a
+// random ancestor (a walk back along its prerequisites), half two courses
+// of one department.
+static inline EdgeList makeReachQueries(const CsrGraph& graph, size_t count) {
+    const uint32_t nodes = (uint32_t)graph.nodeCount();
+    Xorshift rng(3);
+    EdgeList queries(count);
+    for (size_t i = 0; i < queries.size(); ++i) {
+        CourseId v = (CourseId)(rng() % nodes), a = v;
+        if (i % 2 == 0)
+            for (size_t steps = 1 + rng() % 4; steps > 0 && graph.indegree(a) > 0; --steps)
+                a = graph.predecessors(a).begin()[rng() % graph.indegree(a)];
+        else a = std::min(nodes - 1, v - v % 200 + (CourseId)(rng() % 200));
+        queries[i] = { a, v };
+    }
+    return queries;
+}
+
+// The index-free answer: a depth-first search back from v through the
+// prerequisite rows, looking for a.
+struct PrereqSearch {
+    const CsrGraph& graph;
+    std::vector<uint32_t> stamp;
+    std::vector<CourseId> stack;
+    uint32_t round = 0;
+
+    explicit PrereqSearch(const CsrGraph& g) : graph(g), stamp(g.nodeCount(), 0) {}
+
+    bool operator()(CourseId a, CourseId v) {
+        ++round;
+        stack.assign(1, v);
+        while (!stack.empty()) {
+            CourseId u = stack.back();
+            stack.pop_back();
+            for (CourseId p : graph.predecessors(u)) {
+                if (p == a) return true;
+                if (stamp[p] != round) {
+                    stamp[p] = round;
+                    stack.push_back(p);
+                }
+            }
+        }
+        return false;
+    }
+};
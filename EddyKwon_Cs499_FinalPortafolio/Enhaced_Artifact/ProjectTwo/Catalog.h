@@ -0,0 +1,940 @@
+﻿// Catalog.h
+// CS499 – Final ePortfolio Artifact (Advising Assistance Program)
+//
+// Description:
+// The loaded catalog and the queries built on it that print nothing: the
+// string helpers, the Catalog class, the CSV loader, the walk in code
+// order, the graph queries (recommended order, unlocks) and the snapshot
+// builder. The menu and batch mode in ProjectTwo.cpp print from these;
+// the benchmarks and self-tests call them directly.
+
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Closure.h"
+#include "CodeCompleter.h"
+#include "CourseCode.h"
+#include "CourseTable.h"
+#include "CsrGraph.h"
+#include "CsvScan.h"
+#include "DynamicTopo.h"
+#include "FuzzyIndex.h"
+#include "Interner.h"
+#include "KahnFrontier.h"
+#include "LevelOrder.h"
+#include "MappedFile.h"
+#include "RadixSort.h"
+#include "ReachLabels.h"
+#include "Snapshot.h"
+#include "TextEncoding.h"
+#include "ThreadPool.h"
+#include "TitleIndex.h"
+
+// -----------------------------------------------------------------------------
+// String helpers
+// -----------------------------------------------------------------------------
+static inline void ltrim(std::string& s) {
+    s.erase(s.begin(), std::find_if(s.begin(), s.end(),
+        [](unsigned char ch) { return !std::isspace(ch); }));
+}
+static inline void rtrim(std::string& s) {
+    s.erase(std::find_if(s.rbegin(), s.rend(),
+        [](unsigned char ch) { return !std::isspace(ch); }).base(), s.end());
+}
+static inline void trim(std::string& s) { ltrim(s); rtrim(s); }
+
+static inline void stripBOM(std::string& s) {
+    if (s.size() >= 3 &&
+        (unsigned char)s[0] == 0xEF && (unsigned char)s[1] == 0xBB && (unsigned char)s[2] == 0xBF) {
+        s.erase(0, 3);
+    }
+}
+
+static inline bool isSpace(unsigned char ch) {
+    return ch == ' ' || (ch >= '\t' && ch <= '\r');
+}
+
+static inline std::string_view trimView(std::string_view s) {
+    size_t b = 0, e = s.size();
+    while (b < e && isSpace((unsigned char)s[b])) ++b;
+    while (e > b && isSpace((unsigned char)s[e - 1])) --e;
+    return s.substr(b, e - b);
+}
+
+static inline std::string_view stripBOMView(std::string_view s) {
+    if (s.size() >= 3 &&
+        (unsigned char)s[0] == 0xEF && (unsigned char)s[1] == 0xBB && (unsigned char)s[2] == 0xBF) {
+        s.remove_prefix(3);
+    }
+    return s;
+}
+
+// Appends the canonical form of s (alphanumerics only, upper case) to out.
+static inline void appendCanon(std::string_view s, std::string& out) {
+    size_t base = out.size();
+    out.resize(base + s.size());
+    out.resize(base + canonInto(s, &out[base]));
+}
+
+static inline std::string canonCode(std::string_view s) {
+    std::string out;
+    out.reserve(s.size());
+    appendCanon(s, out);
+    return out;
+}
+
+static inline std::vector<std::string> splitCSV(const std::string& line) {
+    std::vector<std::string> parts;
+    std::string field;
+    std::istringstream ss(line);
+    while (std::getline(ss, field, ',')) {
+        stripBOM(field);
+        trim(field);
+        parts.push_back(field);
+    }
+    return parts;
+}
+
+// Parses a whole decimal count no larger than max; false on anything else
+// (signs, spaces, trailing text, overflow).
+static inline bool parseCount(std::string_view text, size_t max, size_t& out) {
+    if (text.empty() || text.size() > 19) return false;
+    size_t value = 0;
+    for (char ch : text) {
+        if (ch < '0' || ch > '9') return false;
+        value = value * 10 + (size_t)(ch - '0');
+    }
+    if (value > max) return false;
+    out = value;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Catalog: interned codes plus the courses defined in the CSV
+// -----------------------------------------------------------------------------
+class Catalog {
+private:
+    CodeInterner codes_;                // every code seen, courses and prereqs
+    CourseTable courses_;               // defined courses, first-seen order
+    std::vector<uint32_t> slot_;        // CourseId -> row of courses_
+    std::vector<uint64_t> sortKey_;     // CourseId -> codeSortKey
+
+    // Rows of courses_ in code order, with their sort keys alongside for
+    // range queries. Built when a load finishes (or on first use) and kept
+    // sorted by put() from then on.
+    mutable std::vector<uint32_t> order_;
+    mutable std::vector<uint64_t> orderKeys_;
+    mutable bool ordered_ = false;
+
+    // Prefix completion over the course codes (see CodeCompleter.h). Built
+    // on first use; adding a course drops it until the next use.
+    mutable CodeCompleter completer_;
+    mutable bool completerBuilt_ = false;
+
+    // Full-text index over the titles, by CourseId (see TitleIndex.h).
+    // Built when a load finishes; put() marks it stale and the next search
+    // rebuilds it.
+    mutable TitleIndex titles_;
+    mutable bool titlesBuilt_ = false;
+
+    // Typo-tolerant code lookup (see FuzzyIndex.h). Built on the first
+    // miss; adding a course drops it until the next one.
+    mutable FuzzyIndex fuzzy_;
+    mutable bool fuzzyBuilt_ = false;
+
+    // Prerequisite graph over CourseIds with an edge prerequisite -> course,
+    // so a course's successors are the courses it unlocks. Prerequisites
+    // that are not courses contribute no edges. Built when a load finishes;
+    // put() marks it stale and the next use rebuilds it, while the edit
+    // methods patch it in place.
+    mutable CsrGraph graph_;
+    mutable bool graphBuilt_ = false;
+
+    // Transitive closure of graph_ (see Closure.h). Built on first use and
+    // dropped by any change to the graph.
+    mutable TransitiveClosure closure_;
+    mutable bool closureBuilt_ = false;
+
+    // Reachability labels over graph_ (see ReachLabels.h), for when the
+    // closure does not fit. Built on first use and dropped like the closure.
+    mutable ReachLabels reach_;
+    mutable bool reachBuilt_ = false;
+
+    // Topological order over every code, so the edit methods below can
+    // reject a prerequisite that would close a cycle without searching the
+    // graph (see DynamicTopo.h). Built on first use, kept up to date by the
+    // edits, dropped by put(). Which valid order it holds depends on the
+    // edit history, so the recommended order is never read from it.
+    mutable DynamicTopoOrder topo_;
+    mutable bool topoBuilt_ = false;
+
+    // The recommended order with the code tie-break (see DynamicTopo.h):
+    // built over graph_ on first use, repaired by the edit methods, dropped
+    // by put(). Not valid() while the courses have a cycle.
+    mutable RankedTopoOrder ranked_;
+    mutable bool rankedBuilt_ = false;
+
+    void buildGraph() const {
+        graph_.build(codes_.size(), [&](auto&& emit) {
+            for (const Course& c : courses_)
+                for (CourseId p : c.prereqs())
+                    if (hasCourse(p)) emit(p, c.id());
+        });
+        graphBuilt_ = true;
+    }
+
+    void buildTitles(ThreadPool* pool = nullptr) const {
+        titles_.build((uint32_t)codes_.size(), [&](CourseId id) {
+            return hasCourse(id) ? courses_.title(slot_[id]) : std::string_view();
+        }, pool);
+        titlesBuilt_ = true;
+    }
+
+    bool codeLess(uint32_t rowA, uint32_t rowB) const { return idLess(courses_.id(rowA), courses_.id(rowB)); }
+
+    // Radix sort on the packed keys (see RadixSort.h), on the pool when one
+    // is given; runs of equal keys are then finished with codeLess.
+    void buildOrder(ThreadPool* pool = nullptr) const {
+        order_.resize(courses_.size());
+        for (uint32_t r = 0; r < order_.size(); ++r) order_[r] = r;
+        auto keyOf = [&](uint32_t row) { return sortKey_[courses_.id(row)]; };
+        radixSortByU64(order_, keyOf, pool);
+        for (size_t i = 0, j; i < order_.size(); i = j) {
+            for (j = i + 1; j < order_.size() && keyOf(order_[j]) == keyOf(order_[i]); ++j) {}
+            if (j - i > 1)
+                std::sort(order_.begin() + i, order_.begin() + j, [&](uint32_t a, uint32_t b) { return codeLess(a, b); });
+        }
+        orderKeys_.resize(order_.size());
+        for (size_t i = 0; i < order_.size(); ++i) orderKeys_[i] = keyOf(order_[i]);
+        ordered_ = true;
+    }
+
+    // put() without touching the graph or the orders over it: stores the
+    // course and drops the indexes the change makes stale. The edit
+    // methods patch the rest themselves.
+    void store(CourseId id, std::string_view title, IdSpan prereqs) {
+        titlesBuilt_ = false;
+        closureBuilt_ = false;
+        reachBuilt_ = false;
+        if (hasCourse(id)) {
+            courses_.assign(slot_[id], title, prereqs);
+            return;
+        }
+        uint32_t row = courses_.append(id, title, prereqs);
+        slot_[id] = row;
+        completerBuilt_ = false;
+        fuzzyBuilt_ = false;
+        if (ordered_) {
+            auto at = std::lower_bound(order_.begin(), order_.end(), row,
+                [&](uint32_t a, uint32_t b) { return codeLess(a, b); });
+            orderKeys_.insert(orderKeys_.begin() + (at - order_.begin()), sortKey_[id]);
+            order_.insert(at, row);
+        }
+    }
+
+    // After an edit has patched graph_: repairs the recommended order
+    // around the touched courses (see RankedTopoOrder::repair), or drops it
+    // when the edit closed a cycle.
+    void repairRanked(const std::vector<CourseId>& touched) {
+        if (!rankedBuilt_) return;
+        const CsrGraph& g = graph_;
+        if (!ranked_.repair(codes_.size(), touched, [&](CourseId id) { return hasCourse(id); },
+                [&](CourseId id) { return g.predecessors(id); }, [&](CourseId id) { return g.successors(id); },
+                [&](CourseId a, CourseId b) { return idLess(a, b); }))
+            rankedBuilt_ = false;
+    }
+
+public:
+    static constexpr uint32_t npos = UINT32_MAX;
+
+    bool empty() const { return courses_.empty(); }
+    size_t size() const { return courses_.size(); }
+    size_t idCount() const { return codes_.size(); }
+
+    void clear() {
+        codes_.clear();
+        courses_.clear();
+        slot_.clear();
+        sortKey_.clear();
+        order_.clear();
+        orderKeys_.clear();
+        ordered_ = false;
+        completer_.clear();
+        completerBuilt_ = false;
+        titles_.clear();
+        titlesBuilt_ = false;
+        fuzzy_.clear();
+        fuzzyBuilt_ = false;
+        graph_.clear();
+        graphBuilt_ = false;
+        closure_.clear();
+        closureBuilt_ = false;
+        reach_.clear();
+        reachBuilt_ = false;
+        topo_.clear();
+        topoBuilt_ = false;
+        ranked_.clear();
+        rankedBuilt_ = false;
+    }
+
+    void reserve(size_t courses, size_t prereqs = 0) {
+        codes_.reserve(courses);
+        courses_.reserve(courses, prereqs);
+        slot_.reserve(courses);
+        sortKey_.reserve(courses);
+    }
+
+    CourseId intern(std::string_view canonical) {
+        CourseId id = codes_.intern(canonical);
+        if (id >= slot_.size()) {
+            slot_.resize((size_t)id + 1, npos);
+            sortKey_.resize((size_t)id + 1, 0);
+            sortKey_[id] = codeSortKey(canonical);
+        }
+        return id;
+    }
+
+    CourseId idOf(std::string_view canonical) const { return codes_.find(canonical); }
+
+    // Natural code order (see CourseCode.h): integer keys first, the code
+    // text only when two keys are equal.
+    bool idLess(CourseId a, CourseId b) const {
+        if (sortKey_[a] != sortKey_[b]) return sortKey_[a] < sortKey_[b];
+        return naturalLess(code(a), code(b));
+    }
+
+    // Switches code lookups to a minimal perfect hash (see Interner.h).
+    // Any later intern() or put() of a new code thaws it again.
+    bool freeze() { return codes_.freeze(); }
+    bool frozen() const { return codes_.frozen(); }
+
+    std::string_view code(CourseId id) const { return codes_.name(id); }
+    bool hasCourse(CourseId id) const { return id < slot_.size() && slot_[id] != npos; }
+
+    // Empty (false) view when the id is not a defined course.
+    Course find(CourseId id) const { return hasCourse(id) ? courses_[slot_[id]] : Course(); }
+    Course find(std::string_view canonical) const { return find(idOf(canonical)); }
+
+    // Defines (or redefines) the course with this id: the last line wins.
+    // A new course is inserted into the code order if it is built; a
+    // redefinition keeps its place.
+    void put(CourseId id, std::string_view title, IdSpan prereqs) {
+        topoBuilt_ = false;
+        graphBuilt_ = false;
+        rankedBuilt_ = false;
+        store(id, title, prereqs);
+    }
+
+    // Edits that keep the topological order, the graph and the recommended
+    // order current instead of dropping them. New prerequisites are checked
+    // against the topological order when it exists; in a catalog that
+    // already has a cycle it does not, and edits go through unchecked.
+
+    // Makes course (a defined course) require prereq (any code). False,
+    // changing nothing, if prereq already depends on course: that would
+    // close a cycle.
+    bool addPrereq(CourseId course, CourseId prereq) {
+        Course c = find(course);
+        if (topoOrder().valid()) {
+            topo_.resize(codes_.size());
+            if (!topo_.addEdge(prereq, course)) return false;
+        }
+        std::vector<CourseId> prereqs(c.prereqs().begin(), c.prereqs().end());
+        prereqs.push_back(prereq);
+        std::string title(c.title());
+        store(course, title, { prereqs.data(), prereqs.data() + prereqs.size() });
+        if (graphBuilt_ && hasCourse(prereq)) {
+            graph_.addEdge(prereq, course);
+            repairRanked({ course });
+        }
+        return true;
+    }
+
+    // Drops every listing of prereq from course; false if there was none.
+    bool removePrereq(CourseId course, CourseId prereq) {
+        Course c = find(course);
+        std::vector<CourseId> prereqs(c.prereqs().begin(), c.prereqs().end());
+        size_t listed = prereqs.size();
+        prereqs.erase(std::remove(prereqs.begin(), prereqs.end(), prereq), prereqs.end());
+        if (prereqs.size() == listed) return false;
+        if (topoBuilt_ && topo_.valid())
+            for (size_t i = prereqs.size(); i < listed; ++i) topo_.removeEdge(prereq, course);
+        else topoBuilt_ = false;    // the cycle may be gone
+        std::string title(c.title());
+        store(course, title, { prereqs.data(), prereqs.data() + prereqs.size() });
+        if (graphBuilt_ && hasCourse(prereq)) {
+            for (size_t i = prereqs.size(); i < listed; ++i) graph_.removeEdge(prereq, course);
+            repairRanked({ course });
+        }
+        return true;
+    }
+
+    // Defines a course with no prerequisites; false if it exists.
+    bool addCourse(CourseId id, std::string_view title) {
+        if (hasCourse(id)) return false;
+        // The courses that already list id gain an edge from it; the graph
+        // only has edges between courses, so they come from the order.
+        if ((topoBuilt_ || graphBuilt_) && topoOrder().valid()) topo_.resize(codes_.size());
+        store(id, title, {});
+        if (!graphBuilt_) return true;
+        if (!topo_.valid()) {
+            graphBuilt_ = false;
+            rankedBuilt_ = false;
+            return true;
+        }
+        std::vector<CourseId> touched{ id };
+        graph_.resize(codes_.size());
+        for (CourseId v : topo_.successors(id)) {
+            graph_.addEdge(id, v);
+            touched.push_back(v);
+        }
+        repairRanked(touched);
+        return true;
+    }
+
+    // Deletes a course and its prerequisite list; courses that list it
+    // keep the code, as a prerequisite that is not a course. False if it
+    // is not a course.
+    bool removeCourse(CourseId id) {
+        if (!hasCourse(id)) return false;
+        if (topoBuilt_ && topo_.valid())
+            for (CourseId p : find(id).prereqs()) topo_.removeEdge(p, id);
+        else topoBuilt_ = false;
+        std::vector<CourseId> touched{ id };
+        if (graphBuilt_) {
+            for (CourseId p : find(id).prereqs())
+                if (hasCourse(p)) graph_.removeEdge(p, id);
+            while (graph_.outdegree(id) > 0) {
+                const CourseId v = graph_.successors(id)[0];
+                graph_.removeEdge(id, v);
+                touched.push_back(v);
+            }
+        }
+        const uint32_t row = slot_[id], last = (uint32_t)courses_.size() - 1;
+        if (ordered_) {
+            auto position = [&](uint32_t r) {
+                return std::lower_bound(order_.begin(), order_.end(), r, [&](uint32_t a, uint32_t b) { return codeLess(a, b); }) - order_.begin();
+            };
+            auto at = position(row);
+            order_[position(last)] = row;   // the last row moves into row
+            order_.erase(order_.begin() + at);
+            orderKeys_.erase(orderKeys_.begin() + at);
+        }
+        courses_.erase(row);
+        if (row != last) slot_[courses_.id(row)] = row;
+        slot_[id] = npos;
+        titlesBuilt_ = false;
+        closureBuilt_ = false;
+        reachBuilt_ = false;
+        completerBuilt_ = false;
+        fuzzyBuilt_ = false;
+        repairRanked(touched);
+        return true;
+    }
+
+    // Call once loading ends: drops storage left behind by redefined
+    // courses and builds the code order, the prerequisite graph and the
+    // title index (sorting on pool, if given).
+    void finishLoad(ThreadPool* pool = nullptr) {
+        courses_.compact();
+        buildOrder(pool);
+        buildGraph();
+        buildTitles(pool);
+    }
+
+    const CsrGraph& graph() const {
+        if (!graphBuilt_) buildGraph();
+        return graph_;
+    }
+
+    const TransitiveClosure& closure() const {
+        if (!closureBuilt_) {
+            const CsrGraph& g = graph();
+            closure_.build(codes_.size(), [&](CourseId id) { return g.successors(id); });
+            closureBuilt_ = true;
+        }
+        return closure_;
+    }
+
+    // Not valid() when the prerequisites have a cycle.
+    const DynamicTopoOrder& topoOrder() const {
+        if (!topoBuilt_) {
+            topo_.build(codes_.size(), [&](auto&& emit) {
+                for (const Course& c : courses_)
+                    for (CourseId p : c.prereqs()) emit(p, c.id());
+            }, [](CourseId id) { return id; });
+            topoBuilt_ = true;
+        }
+        return topo_;
+    }
+
+    // The recommended order with the code tie-break, as recommendedOrder()
+    // gives it; not valid() when the courses have a cycle.
+    const RankedTopoOrder& rankedOrder() const {
+        if (!rankedBuilt_) {
+            const CsrGraph& g = graph();
+            if (!ordered_) buildOrder();
+            std::vector<uint32_t> rank(codes_.size());
+            for (uint32_t i = 0; i < order_.size(); ++i) rank[courses_.id(order_[i])] = i;
+            ranked_.build(g.nodeCount(), [&](CourseId id) { return hasCourse(id); },
+                [&](CourseId id) { return g.indegree(id); }, [&](CourseId id) { return g.successors(id); },
+                [&](CourseId id) { return rank[id]; });
+            rankedBuilt_ = true;
+        }
+        return ranked_;
+    }
+
+    const ReachLabels& reachLabels() const {
+        if (!reachBuilt_) {
+            const CsrGraph& g = graph();
+            reach_.build(codes_.size(), [&](CourseId id) { return g.successors(id); });
+            reachBuilt_ = true;
+        }
+        return reach_;
+    }
+
+    // The i-th course in code order, i < size().
+    Course ordered(size_t i) const {
+        if (!ordered_) buildOrder();
+        return courses_[order_[i]];
+    }
+
+    // Calls fn(course) for up to k courses whose codes start with the
+    // canonical prefix, shorter codes first; returns how many.
+    template <class Fn>
+    size_t complete(std::string_view prefix, size_t k, Fn&& fn) const {
+        auto codeAt = [&](CourseId id) { return code(id); };
+        if (!completerBuilt_) {
+            std::vector<uint32_t> ids;
+            ids.reserve(courses_.size());
+            for (const Course& c : courses_) ids.push_back(c.id());
+            completer_.build(std::move(ids), codeAt);
+            completerBuilt_ = true;
+        }
+        return completer_.view().complete(prefix, k, codeAt, [&](CourseId id) { fn(find(id)); });
+    }
+
+    // Calls fn(course, distance) for up to k courses whose codes are within
+    // fuzzyRadius of the canonical code, closest first and then in code
+    // order; returns how many.
+    template <class Fn>
+    size_t nearest(std::string_view canonical, size_t k, Fn&& fn) const {
+        if (!fuzzyBuilt_) {
+            std::vector<uint32_t> ids;
+            ids.reserve(courses_.size());
+            for (const Course& c : courses_) ids.push_back(c.id());
+            fuzzy_.build(ids, [&](CourseId id) { return code(id); });
+            fuzzyBuilt_ = true;
+        }
+        auto hits = fuzzy_.view().nearest(canonical, fuzzyRadius(canonical), k,
+            [&](CourseId a, CourseId b) { return idLess(a, b); });
+        for (const auto& h : hits) fn(find(h.first), h.second);
+        return hits.size();
+    }
+
+    // Calls fn(course, score) for the k best courses whose titles hold
+    // every term of query (BM25, equal scores in code order); returns how
+    // many courses matched in all.
+    template <class Fn>
+    size_t searchTitles(std::string_view query, size_t k, Fn&& fn) const {
+        if (!titlesBuilt_) buildTitles();
+        std::vector<TitleIndexView::Hit> hits;
+        size_t found = titles_.view().search(query, k, [&](CourseId a, CourseId b) { return idLess(a, b); }, hits);
+        for (const TitleIndexView::Hit& h : hits) fn(find(h.doc), h.score);
+        return found;
+    }
+
+    // Sort key (codeSortKey) of the i-th course in code order.
+    uint64_t orderedKey(size_t i) const {
+        if (!ordered_) buildOrder();
+        return orderKeys_[i];
+    }
+
+    size_t memoryBytes() const {
+        return codes_.memoryBytes() + courses_.memoryBytes() +
+            (slot_.capacity() + order_.capacity()) * sizeof(uint32_t) +
+            (sortKey_.capacity() + orderKeys_.capacity()) * sizeof(uint64_t) + completer_.memoryBytes() +
+            titles_.memoryBytes() + fuzzy_.memoryBytes() + graph_.memoryBytes() +
+            closure_.memoryBytes() + reach_.memoryBytes() + topo_.memoryBytes() + ranked_.memoryBytes();
+    }
+
+    CourseTable::const_iterator begin() const { return courses_.begin(); }
+    CourseTable::const_iterator end() const { return courses_.end(); }
+};
+
+// -----------------------------------------------------------------------------
+// Load courses from CSV into catalog
+// -----------------------------------------------------------------------------
+
+// Canonicalized rows of one chunk, stored back to back so that parsing
+// allocates per chunk rather than per field. Row r owns the fields
+// [rowEnds[r - 1], rowEnds[r]) of fieldEnds: code, title, then prereqs.
+struct ParsedRows {
+    std::string text;
+    std::vector<uint32_t> fieldEnds;
+    std::vector<uint32_t> rowEnds;
+
+    std::string_view field(size_t k) const {
+        size_t b = k ? fieldEnds[k - 1] : 0;
+        return std::string_view(text.data() + b, fieldEnds[k] - b);
+    }
+};
+
+// Parses a CSV buffer in place. Only the canonical code, title and
+// prerequisite codes of kept rows are copied out of the buffer.
+static inline void parseRows(std::string_view buf, ParsedRows& rows) {
+    CsvScanner scanner;
+    std::vector<std::string_view> fields;
+
+    scanner.forEachRecord(buf, fields,
+        [&](std::string_view line, const std::vector<std::string_view>& f) {
+            std::string_view check = trimView(stripBOMView(line));
+            if (check.empty() || check[0] == '#') return;
+            if (f.size() < 2) return;
+
+            appendCanon(f[0], rows.text);
+            rows.fieldEnds.push_back((uint32_t)rows.text.size());
+            rows.text.append(f[1]);
+            rows.fieldEnds.push_back((uint32_t)rows.text.size());
+            for (size_t i = 2; i < f.size(); ++i) {
+                size_t before = rows.text.size();
+                appendCanon(f[i], rows.text);
+                if (rows.text.size() != before) rows.fieldEnds.push_back((uint32_t)rows.text.size());
+            }
+            rows.rowEnds.push_back((uint32_t)rows.fieldEnds.size());
+        });
+}
+
+// Interns the codes of each row and defines its course, in row order.
+static inline void mergeRows(const ParsedRows& rows, Catalog& catalog) {
+    std::vector<CourseId> prereqs;
+    size_t k = 0;
+    for (uint32_t end : rows.rowEnds) {
+        CourseId id = catalog.intern(rows.field(k));
+        prereqs.clear();
+        for (size_t i = k + 2; i < end; ++i) prereqs.push_back(catalog.intern(rows.field(i)));
+        catalog.put(id, rows.field(k + 1), { prereqs.data(), prereqs.data() + prereqs.size() });
+        k = end;
+    }
+}
+
+static inline void parseCourses(std::string_view buf, Catalog& catalog) {
+    ParsedRows rows;
+    parseRows(buf, rows);
+    catalog.reserve(rows.rowEnds.size(), rows.fieldEnds.size() - 2 * rows.rowEnds.size());
+    mergeRows(rows, catalog);
+    catalog.finishLoad();
+}
+
+// Parallel ingest: the buffer is cut into chunks at newline boundaries,
+// chunks are parsed and canonicalized on the thread pool, and the results
+// are merged in chunk order so "last line wins" matches parseCourses.
+static inline void parseCoursesParallel(std::string_view buf, Catalog& catalog, ThreadPool& pool) {
+    size_t chunkCount = (size_t)pool.size() * 4;
+    std::vector<std::string_view> chunks;
+    size_t begin = 0;
+    for (size_t i = 1; i <= chunkCount && begin < buf.size(); ++i) {
+        size_t end = (i == chunkCount) ? buf.size() : std::max(begin, buf.size() / chunkCount * i);
+        const char* nl = (const char*)std::memchr(buf.data() + end, '\n', buf.size() - end);
+        end = nl ? (size_t)(nl - buf.data()) + 1 : buf.size();
+        chunks.push_back(buf.substr(begin, end - begin));
+        begin = end;
+    }
+
+    std::vector<ParsedRows> parsed(chunks.size());
+    pool.parallelFor(chunks.size(), [&](size_t i) { parseRows(chunks[i], parsed[i]); });
+
+    size_t rowCount = 0, prereqCount = 0;
+    for (const auto& part : parsed) {
+        rowCount += part.rowEnds.size();
+        prereqCount += part.fieldEnds.size() - 2 * part.rowEnds.size();
+    }
+    catalog.reserve(rowCount, prereqCount);
+    for (auto& part : parsed) {
+        mergeRows(part, catalog);
+        part = ParsedRows();
+    }
+    catalog.finishLoad(&pool);
+}
+
+struct LoadOptions {
+    unsigned threads = 0;   // 0 = pick automatically, 1 = sequential
+    bool freeze = false;    // build the perfect-hash lookup after loading
+};
+
+// Files below this size are parsed sequentially in automatic mode.
+static const size_t kParallelLoadMinBytes = 1 << 20;
+
+static inline bool loadCourses(const std::string& filename, Catalog& catalog,
+    const LoadOptions& opts = LoadOptions()) {
+    // Map the file; inputs that cannot be mapped (pipes, devices) are read.
+    MappedFile file;
+    std::string contents;
+    std::string_view buf;
+    if (file.open(filename)) {
+        buf = file.view();
+    }
+    else {
+        std::ifstream fin(filename, std::ios::binary);
+        if (!fin.is_open()) return false;
+        contents.assign(std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>());
+        buf = contents;
+    }
+
+    // UTF-16 exports are transcoded up front; the parser sees UTF-8 only.
+    std::string utf8;
+    EncodingInfo enc = detectEncoding(buf);
+    if (enc.encoding != TextEncoding::Utf8) {
+        transcodeUtf16(buf.substr(enc.bomBytes), enc.encoding == TextEncoding::Utf16BE, utf8);
+        buf = utf8;
+    }
+
+    catalog.clear();
+    bool parallel = opts.threads > 1 ||
+        (opts.threads == 0 && buf.size() >= kParallelLoadMinBytes && ThreadPool::shared().size() > 1);
+    if (!parallel) {
+        parseCourses(buf, catalog);
+    }
+    else if (opts.threads == 0) {
+        parseCoursesParallel(buf, catalog, ThreadPool::shared());
+    }
+    else {
+        ThreadPool pool(opts.threads);
+        parseCoursesParallel(buf, catalog, pool);
+    }
+    if (opts.freeze) catalog.freeze();
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Code order
+// -----------------------------------------------------------------------------
+
+// Course ids in code order (a copy of the catalog's order index).
+static inline std::vector<CourseId> sortedCourseIds(const Catalog& catalog) {
+    std::vector<CourseId> ids;
+    ids.reserve(catalog.size());
+    for (size_t i = 0; i < catalog.size(); ++i) ids.push_back(catalog.ordered(i).id());
+    return ids;
+}
+
+// Walks the catalog in code order a batch of rows at a time, so a listing
+// can be streamed or paged without collecting the rows first.
+class CourseCursor {
+private:
+    const Catalog& catalog_;
+    size_t pos_ = 0;
+
+public:
+    explicit CourseCursor(const Catalog& catalog) : catalog_(catalog) {}
+
+    bool done() const { return pos_ >= catalog_.size(); }
+    size_t position() const { return pos_; }
+
+    // Calls fn(course) for up to `limit` courses; returns how many.
+    template <class Fn>
+    size_t next(size_t limit, Fn&& fn) {
+        size_t end = std::min(catalog_.size(), pos_ + limit);
+        size_t count = end - pos_;
+        for (; pos_ < end; ++pos_) fn(catalog_.ordered(pos_));
+        return count;
+    }
+};
+
+// Result counts the menu and batch mode show, and the benchmarks measure:
+// completions offered by --complete and "Did you mean", and the best
+// title matches of menu 10 and --search.
+static const size_t kCompletions = 10;
+static const size_t kTitleResults = 10;
+
+// -----------------------------------------------------------------------------
+// Graph queries
+// -----------------------------------------------------------------------------
+
+// Which ready course the recommended order takes first: the first in code
+// order, the one with the shortest prerequisite chain, or the one that
+// directly unlocks the most courses. Ties go to code order.
+enum class TieBreak { Code, Level, Unlocks };
+
+static inline bool parseTieBreak(std::string_view name, TieBreak& out) {
+    if (name.empty() || name == "code") out = TieBreak::Code;
+    else if (name == "level") out = TieBreak::Level;
+    else if (name == "unlocks") out = TieBreak::Unlocks;
+    else return false;
+    return true;
+}
+
+// Kahn's algorithm with the frontier that suits the tie-break (see
+// KahnFrontier.h); rank(u) is u's position in code order. Appends the
+// courses released to order.
+template <class Ready, class Successors, class Rank>
+static void kahnOrder(std::vector<uint32_t>& order, size_t nodes, TieBreak tieBreak, Ready&& ready,
+    std::vector<uint32_t> indegree, Successors&& successors, Rank&& rank) {
+    switch (tieBreak) {
+    case TieBreak::Code: {
+        DaryHeap<4> frontier;
+        kahnSort(frontier, nodes, ready, indegree, successors, [&](uint32_t u) { return (uint64_t)rank(u); }, order);
+        break;
+    }
+    case TieBreak::Level: {
+        LevelOrder levels;
+        levels.build(nodes, [&](uint32_t u) { return indegree[u]; }, successors, &ThreadPool::shared());
+        BucketQueue frontier;
+        kahnSort(frontier, nodes, ready, indegree, successors,
+            [&](uint32_t u) { return (uint64_t)levels.level(u) << 32 | rank(u); }, order);
+        break;
+    }
+    case TieBreak::Unlocks: {
+        DaryHeap<4> frontier;
+        kahnSort(frontier, nodes, ready, indegree, successors,
+            [&](uint32_t u) { return (uint64_t)(UINT32_MAX - (uint32_t)successors(u).size()) << 32 | rank(u); }, order);
+        break;
+    }
+    }
+}
+
+// The catalog's courses in recommended order, the same however the
+// catalog was loaded or edited; courses on or after a prerequisite cycle
+// are left out. The code tie-break reads the order the catalog keeps
+// repaired across edits (see Catalog::rankedOrder); the others, and a
+// catalog with a cycle, sort afresh.
+static inline std::vector<CourseId> recommendedOrder(const Catalog& catalog, TieBreak tieBreak = TieBreak::Code) {
+    if (tieBreak == TieBreak::Code && catalog.rankedOrder().valid()) return catalog.rankedOrder().order();
+    const CsrGraph& graph = catalog.graph();
+    std::vector<uint32_t> indegree(catalog.idCount()), rank(catalog.idCount());
+    for (uint32_t i = 0; i < catalog.size(); ++i) {
+        CourseId id = catalog.ordered(i).id();
+        rank[id] = i;
+        indegree[id] = graph.indegree(id);
+    }
+    std::vector<CourseId> order;
+    order.reserve(catalog.size());
+    kahnOrder(order, catalog.idCount(), tieBreak, [&](CourseId id) { return catalog.hasCourse(id); },
+        std::move(indegree), [&](CourseId id) { return graph.successors(id); }, [&](CourseId id) { return rank[id]; });
+    return order;
+}
+
+// Courses that depend on start: its direct unlocks (depth 1) and, when
+// transitive, everything reachable from those, breadth-first. Each course
+// appears once, at its shortest depth. successors(id) lists the courses
+// that require id; nodes bounds the ids.
+template <class Successors>
+static std::vector<std::pair<uint32_t, uint32_t>> collectUnlocks(uint32_t start, size_t nodes, bool transitive,
+    Successors&& successors) {
+    std::vector<std::pair<uint32_t, uint32_t>> out;
+    std::vector<bool> seen(nodes, false);
+    seen[start] = true;
+    auto visit = [&](uint32_t from, uint32_t depth) {
+        for (uint32_t v : successors(from))
+            if (!seen[v]) {
+                seen[v] = true;
+                out.emplace_back(v, depth);
+            }
+    };
+    visit(start, 1);
+    for (size_t i = 0; transitive && i < out.size(); ++i) visit(out[i].first, out[i].second + 1);
+    return out;
+}
+
+// -----------------------------------------------------------------------------
+// Binary snapshot (save from a loaded catalog)
+// -----------------------------------------------------------------------------
+static inline SnapshotData buildSnapshotData(const Catalog& catalog) {
+    SnapshotData d;
+    std::vector<CourseId> sorted = sortedCourseIds(catalog);
+    d.courseCount = (uint32_t)sorted.size();
+
+    // Snapshot ids: courses in sorted order first, then prerequisite-only codes.
+    std::vector<uint32_t> snapId(catalog.idCount(), SnapshotView::npos);
+    for (uint32_t i = 0; i < d.courseCount; ++i) {
+        snapId[sorted[i]] = i;
+        d.codes.emplace_back(catalog.code(sorted[i]));
+    }
+
+    d.prereqOffsets.push_back(0);
+    for (CourseId id : sorted) {
+        Course c = catalog.find(id);
+        d.titles.emplace_back(c.title());
+        for (CourseId p : c.prereqs()) {
+            if (snapId[p] == SnapshotView::npos) {
+                snapId[p] = (uint32_t)d.codes.size();
+                d.codes.emplace_back(catalog.code(p));
+            }
+            d.prereqIds.push_back(snapId[p]);
+        }
+        d.prereqOffsets.push_back((uint32_t)d.prereqIds.size());
+    }
+
+    const CsrGraph& graph = catalog.graph();
+    d.succOffsets.push_back(0);
+    for (CourseId id : sorted) {
+        size_t first = d.succIds.size();
+        for (CourseId v : graph.successors(id)) d.succIds.push_back(snapId[v]);
+        std::sort(d.succIds.begin() + first, d.succIds.end());
+        d.succOffsets.push_back((uint32_t)d.succIds.size());
+        d.indegree.push_back(graph.indegree(id));
+    }
+
+    // A frozen catalog carries its perfect hash into the file, rebuilt over
+    // the snapshot's course ids.
+    PerfectHash ph;
+    if (catalog.frozen() && ph.build(d.courseCount, [&](uint32_t id) { return codeHash(d.codes[id]); })) {
+        d.mphPilots = ph.pilots();
+        d.mphRemap = ph.remap();
+        d.mphIds.assign(d.courseCount, 0);
+        for (uint32_t id = 0; id < d.courseCount; ++id) d.mphIds[ph(codeHash(d.codes[id]))] = id;
+    }
+
+    CodeCompleter completer;
+    std::vector<uint32_t> ids(d.courseCount);
+    for (uint32_t id = 0; id < d.courseCount; ++id) ids[id] = id;
+    completer.build(std::move(ids), [&](uint32_t id) { return std::string_view(d.codes[id]); });
+    d.completeIds = completer.ids();
+    d.completeHeads = completer.heads();
+    d.completeLengthStart = completer.lengthStart();
+
+    TitleIndex titles;
+    titles.build(d.courseCount, [&](uint32_t id) { return std::string_view(d.titles[id]); });
+    d.titleTermOffsets = titles.termOffsets();
+    d.titleTermBytes = titles.termBytes();
+    d.titleTermBlocks = titles.termBlocks();
+    d.titleTermDocs = titles.termDocs();
+    d.titleBlockLast = titles.blockLast();
+    d.titleBlockOffsets = titles.blockOffset();
+    d.titlePostings = titles.postings();
+    d.titleDocLength = titles.docLength();
+    d.titleStats[0] = titles.indexedDocs();
+    d.titleStats[1] = titles.totalLength();
+
+    FuzzyIndex fuzzy;
+    std::vector<uint32_t> courseIds(d.courseCount);
+    for (uint32_t id = 0; id < d.courseCount; ++id) courseIds[id] = id;
+    fuzzy.build(courseIds, [&](uint32_t id) { return std::string_view(d.codes[id]); });
+    d.fuzzyIds = fuzzy.ids();
+    d.fuzzyEdges = fuzzy.edges();
+    d.fuzzyChildStart = fuzzy.childStart();
+    d.fuzzyCodeOffsets = fuzzy.codeOffsets();
+    d.fuzzyCodeBytes = fuzzy.codeBytes();
+
+    ReachLabels reach;
+    reach.build(d.courseCount, [&](uint32_t id) {
+        return IdSpan{ d.succIds.data() + d.succOffsets[id], d.succIds.data() + d.succOffsets[id + 1] };
+    });
+    d.reachComponents = reach.components();
+    d.reachPredStart = reach.predStart();
+    d.reachPred = reach.pred();
+    d.reachLabels = reach.labels();
+    return d;
+}
@@ -0,0 +1,224 @@
+﻿// Closure.h
+// CS499 – Final ePortfolio Artifact (Advising Assistance Program)
+//
+// Description:
+// Transitive closure of the prerequisite graph: for every course, the set
+// of courses it requires directly or indirectly, so "is MATH201 required
+// for CSCI400?" is one bit test instead of a graph walk.
+//
+// Rows belong to the components of the condensed graph (Condensation.h),
+// whose topological positions put every ancestor of a component before
+// it, and close to load order, so courses listed together share words
+// and compressed rows stay short. Rows are filled in that order: a row is
+// the OR of its prerequisites' rows plus their own bits, and as those
+// rows are already final only the words below the prerequisite's
+// position are ORed (with AVX2 when the CPU has it).
+//
+// A dense row costs one bit per node, so the matrix grows with the square
+// of the catalog. Past a byte limit the rows are kept compressed instead:
+// only their non-zero 64-bit words, as (word index, word) pairs in index
+// order, found by binary search. Catalogs where most courses require most
+// others outgrow that too; the build then gives up (available() is false)
+// and callers fall back to searching the graph.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Condensation.h"
+#include "Simd.h"
+
+namespace closure {
+
+using OrKernel = void (*)(uint64_t* dst, const uint64_t* src, size_t words);
+
+static inline void orScalar(uint64_t* dst, const uint64_t* src, size_t words) {
+    for (size_t i = 0; i < words; ++i) dst[i] |= src[i];
+}
+
+#if PT_X86
+PT_TARGET("avx2")
+static void orAvx2(uint64_t* dst, const uint64_t* src, size_t words) {
+    size_t i = 0;
+    for (; i + 8 <= words; i += 8) {
+        __m256i a = _mm256_or_si256(_mm256_loadu_si256((const __m256i*)(dst + i)),
+            _mm256_loadu_si256((const __m256i*)(src + i)));
+        __m256i b = _mm256_or_si256(_mm256_loadu_si256((const __m256i*)(dst + i + 4)),
+            _mm256_loadu_si256((const __m256i*)(src + i + 4)));
+        _mm256_storeu_si256((__m256i*)(dst + i), a);
+        _mm256_storeu_si256((__m256i*)(dst + i + 4), b);
+    }
+    for (; i < words; ++i) dst[i] |= src[i];
+}
+#endif
+
+static inline OrKernel activeOrKernel() {
+#if PT_X86
+    return CpuFeatures::get().avx2 ? orAvx2 : orScalar;
+#else
+    return orScalar;
+#endif
+}
+
+// Largest closure built, dense or compressed.
+static const size_t kLimitBytes = (size_t)256 << 20;
+
+} // namespace closure
+
+class TransitiveClosure {
+private:
+    Condensation dag_;
+    std::vector<uint32_t> memberStart_; // positions + 1 into members_
+    std::vector<uint32_t> members_;     // nodes, by position
+    size_t rowWords_ = 0;
+    bool dense_ = true;
+    bool available_ = false;
+    std::vector<uint64_t> bits_;        // dense: row p is [p * rowWords_, +rowWords_)
+    std::vector<uint64_t> rowStart_;    // compressed: positions + 1 into index_/words_
+    std::vector<uint32_t> index_;
+    std::vector<uint64_t> words_;
+
+    // Calls fn(index, word) for each non-zero word of position p's row.
+    template <class Fn>
+    void forEachWord(uint32_t p, Fn&& fn) const {
+        if (dense_) {
+            const uint64_t* row = bits_.data() + (size_t)p * rowWords_;
+            for (size_t i = 0; i < rowWords_; ++i)
+                if (row[i]) fn((uint32_t)i, row[i]);
+            return;
+        }
+        for (uint64_t i = rowStart_[p]; i < rowStart_[p + 1]; ++i) fn(index_[i], words_[i]);
+    }
+
+public:
+    // Builds the closure of a graph with nodes nodes; successors(u) lists
+    // the nodes that require u. The rows are dense when the matrix fits in
+    // limit bytes and compressed otherwise; returns false (leaving the
+    // closure empty) if the compressed rows outgrow limit as well.
+    template <class Successors>
+    bool build(size_t nodes, Successors&& successors, size_t limit = closure::kLimitBytes) {
+        clear();
+        dag_.build(nodes, successors);
+        const uint32_t n = (uint32_t)nodes, c = dag_.size();
+        const std::vector<uint32_t>& succStart = dag_.succStart();
+        const std::vector<uint32_t>& succ = dag_.succ();
+
+        memberStart_.assign(c + 1, 0);
+        for (uint32_t u = 0; u < n; ++u) ++memberStart_[dag_.component(u) + 1];
+        for (uint32_t p = 0; p < c; ++p) memberStart_[p + 1] += memberStart_[p];
+        members_.resize(n);
+        {
+            std::vector<uint32_t> cursor(memberStart_.begin(), memberStart_.end() - 1);
+            for (uint32_t u = 0; u < n; ++u) members_[cursor[dag_.component(u)]++] = u;
+        }
+
+        // Prerequisites of each position.
+        std::vector<uint32_t> predStart(c + 1, 0), preds(succ.size());
+        for (uint32_t v : succ) ++predStart[v + 1];
+        for (uint32_t p = 0; p < c; ++p) predStart[p + 1] += predStart[p];
+        {
+            std::vector<uint32_t> cursor(predStart.begin(), predStart.end() - 1);
+            for (uint32_t p = 0; p < c; ++p)
+                for (uint32_t i = succStart[p]; i < succStart[p + 1]; ++i) preds[cursor[succ[i]]++] = p;
+        }
+
+        rowWords_ = (c + 63) / 64;
+        dense_ = (double)c * rowWords_ * sizeof(uint64_t) <= (double)limit;
+        const closure::OrKernel orWords = closure::activeOrKernel();
+
+        // Row p is built in scratch (the matrix row itself when dense);
+        // touched lists the words that became non-zero, for compressing.
+        std::vector<uint64_t> scratch(dense_ ? 0 : rowWords_, 0);
+        std::vector<uint32_t> touched;
+        if (dense_) bits_.assign((size_t)c * rowWords_, 0);
+        else rowStart_.assign(1, 0);
+
+        for (uint32_t p = 0; p < c; ++p) {
+            uint64_t* row = dense_ ? bits_.data() + (size_t)p * rowWords_ : scratch.data();
+            for (uint32_t i = predStart[p]; i < predStart[p + 1]; ++i) {
+                const uint32_t q = preds[i];
+                if (dense_) orWords(row, bits_.data() + (size_t)q * rowWords_, (q + 63) / 64);
+                else
+                    forEachWord(q, [&](uint32_t at, uint64_t w) {
+                        if (!row[at]) touched.push_back(at);
+                        row[at] |= w;
+                    });
+                if (!row[q >> 6] && !dense_) touched.push_back(q >> 6);
+                row[q >> 6] |= 1ull << (q & 63);
+            }
+
+            if (!dense_) {
+                std::sort(touched.begin(), touched.end());
+                for (uint32_t at : touched) {
+                    index_.push_back(at);
+                    words_.push_back(scratch[at]);
+                    scratch[at] = 0;
+                }
+                touched.clear();
+                rowStart_.push_back(index_.size());
+                if (index_.size() * (sizeof(uint32_t) + sizeof(uint64_t)) > limit) {
+                    *this = TransitiveClosure();    // releases the rows
+                    return false;
+                }
+            }
+        }
+        available_ = true;
+        return true;
+    }
+
+    void clear() {
+        dag_.clear();
+        memberStart_.clear();
+        members_.clear();
+        rowWords_ = 0;
+        dense_ = true;
+        available_ = false;
+        bits_.clear();
+        rowStart_.clear();
+        index_.clear();
+        words_.clear();
+    }
+
+    size_t nodes() const { return dag_.nodes(); }
+    bool available() const { return available_; }
+    bool dense() const { return dense_; }
+
+    // True if node a is required, directly or indirectly, by node v (on a
+    // cycle, a node requires itself). Only valid when available().
+    bool reaches(uint32_t a, uint32_t v) const {
+        const uint32_t pa = dag_.component(a), pv = dag_.component(v);
+        if (pa >= pv) return pa == pv && dag_.cyclic(pv);
+        const uint32_t i = pa >> 6;
+        uint64_t word;
+        if (dense_) word = bits_[(size_t)pv * rowWords_ + i];
+        else {
+            auto first = index_.begin() + (ptrdiff_t)rowStart_[pv], last = index_.begin() + (ptrdiff_t)rowStart_[pv + 1];
+            auto it = std::lower_bound(first, last, i);
+            if (it == last || *it != i) return false;
+            word = words_[(size_t)(it - index_.begin())];
+        }
+        return (word >> (pa & 63)) & 1;
+    }
+
+    // Calls fn(a) for every node that v requires, in topological order
+    // (the members of a cycle in node order).
+    template <class Fn>
+    void forEachAncestor(uint32_t v, Fn&& fn) const {
+        auto component = [&](uint32_t p) {
+            for (uint32_t i = memberStart_[p]; i < memberStart_[p + 1]; ++i) fn(members_[i]);
+        };
+        const uint32_t pv = dag_.component(v);
+        forEachWord(pv, [&](uint32_t at, uint64_t w) {
+            for (; w; w &= w - 1) component(at * 64 + ctz64(w));
+        });
+        if (dag_.cyclic(pv)) component(pv);
+    }
+
+    size_t memoryBytes() const {
+        return dag_.memoryBytes() + (memberStart_.capacity() + members_.capacity() + index_.capacity()) * sizeof(uint32_t) +
+            (bits_.capacity() + rowStart_.capacity() + words_.capacity()) * sizeof(uint64_t);
+    }
+};
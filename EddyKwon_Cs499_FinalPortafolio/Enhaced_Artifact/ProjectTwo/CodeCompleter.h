@@ -0,0 +1,140 @@
+﻿// CodeCompleter.h
+// CS499 – Final ePortfolio Artifact (Advising Assistance Program)
+//
+// Description:
+// Prefix completion of course codes ("CSCI3" -> CSCI300, CSCI301, ...).
+// The index is one sorted array of course ids ordered by (code length,
+// code), plus each code's first eight bytes as a big-endian integer. The
+// codes of one length form a contiguous segment, and inside a segment the
+// codes that start with a prefix are contiguous too, so completing is one
+// binary search per length over the integer array (string compares only
+// past the eighth byte), taking results from the shortest length up until
+// k are found. Shorter codes come first, so "CSCI3" offers CSCI300 before
+// CSCI3000.
+//
+// CompletionView evaluates over borrowed arrays (a CodeCompleter's own
+// vectors or sections of a mapped snapshot), like PerfectHashView.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "RadixSort.h"
+
+// First eight bytes of s, big-endian, zero padded: integer order on heads
+// is byte order on the codes' first eight bytes.
+static inline uint64_t codeHead(std::string_view s) {
+    uint64_t h = 0;
+    for (size_t i = 0; i < 8; ++i) h = h << 8 | (i < s.size() ? (unsigned char)s[i] : 0u);
+    return h;
+}
+
+struct CompletionView {
+    const uint32_t* ids = nullptr;          // by (length, code)
+    const uint64_t* heads = nullptr;        // codeHead of each
+    const uint32_t* lengthStart = nullptr;  // lengths + 1 entries into ids
+    uint32_t lengths = 0;                   // every code is shorter
+
+    bool empty() const { return lengths == 0 || lengthStart[lengths] == 0; }
+
+    // Calls fn(id) for up to k codes starting with the canonical prefix,
+    // shortest first and in byte order within a length; returns how many.
+    // codeAt(id) gives the code of an id.
+    template <class CodeAt, class Fn>
+    size_t complete(std::string_view prefix, size_t k, CodeAt&& codeAt, Fn&& fn) const {
+        const size_t p = prefix.size();
+        const uint64_t lo = codeHead(prefix), hi = p >= 8 ? lo : lo | (~0ull >> (8 * p));
+        std::string_view rest = p > 8 ? prefix.substr(8) : std::string_view();
+        size_t found = 0;
+        for (size_t len = p; len < lengths && found < k; ++len) {
+            const uint64_t* b = heads + lengthStart[len];
+            const uint64_t* e = heads + lengthStart[len + 1];
+            if (b == e || e[-1] < lo || *b > hi) continue;
+            size_t i = (size_t)(std::lower_bound(b, e, lo) - heads), end = (size_t)(e - heads);
+            if (rest.empty()) {
+                // Matches run on from i while the head stays in range.
+                for (; i < end && found < k && heads[i] <= hi; ++i, ++found) fn(ids[i]);
+                continue;
+            }
+            end = (size_t)(std::upper_bound(heads + i, e, hi) - heads);
+            if (i < end) {
+                auto tail = [&](size_t at) { return codeAt(ids[at]).substr(8, rest.size()); };
+                size_t l = i, h = end;
+                while (l < h) {
+                    size_t mid = l + (h - l) / 2;
+                    if (tail(mid) < rest) l = mid + 1;
+                    else h = mid;
+                }
+                i = l;
+                for (h = end; l < h;) {
+                    size_t mid = l + (h - l) / 2;
+                    if (tail(mid) == rest) l = mid + 1;
+                    else h = mid;
+                }
+                end = l;
+            }
+            for (; i < end && found < k; ++i, ++found) fn(ids[i]);
+        }
+        return found;
+    }
+};
+
+class CodeCompleter {
+private:
+    std::vector<uint32_t> ids_;
+    std::vector<uint64_t> heads_;
+    std::vector<uint32_t> lengthStart_;
+
+public:
+    // Indexes ids; codeAt(id) gives each one's canonical code, which must
+    // stay valid while the index is used.
+    template <class CodeAt>
+    void build(std::vector<uint32_t> ids, CodeAt&& codeAt, ThreadPool* pool = nullptr) {
+        size_t lengths = 0;
+        for (uint32_t id : ids) lengths = std::max(lengths, codeAt(id).size() + 1);
+        lengthStart_.assign(lengths + 1, 0);
+        for (uint32_t id : ids) ++lengthStart_[codeAt(id).size() + 1];
+        for (size_t len = 0; len < lengths; ++len) lengthStart_[len + 1] += lengthStart_[len];
+
+        ids_.resize(ids.size());
+        std::vector<uint32_t> cursor(lengthStart_.begin(), lengthStart_.end() - 1);
+        for (uint32_t id : ids) ids_[cursor[codeAt(id).size()]++] = id;
+
+        std::vector<uint32_t> segment;
+        for (size_t len = 0; len < lengths; ++len) {
+            segment.assign(ids_.begin() + lengthStart_[len], ids_.begin() + lengthStart_[len + 1]);
+            radixSortByKey(segment, codeAt, pool);
+            std::copy(segment.begin(), segment.end(), ids_.begin() + lengthStart_[len]);
+        }
+
+        heads_.resize(ids_.size());
+        for (size_t i = 0; i < ids_.size(); ++i) heads_[i] = codeHead(codeAt(ids_[i]));
+    }
+
+    void clear() {
+        ids_.clear();
+        heads_.clear();
+        lengthStart_.clear();
+    }
+
+    CompletionView view() const {
+        CompletionView v;
+        v.ids = ids_.data();
+        v.heads = heads_.data();
+        v.lengthStart = lengthStart_.data();
+        v.lengths = lengthStart_.empty() ? 0 : (uint32_t)lengthStart_.size() - 1;
+        return v;
+    }
+
+    const std::vector<uint32_t>& ids() const { return ids_; }
+    const std::vector<uint64_t>& heads() const { return heads_; }
+    const std::vector<uint32_t>& lengthStart() const { return lengthStart_; }
+
+    size_t memoryBytes() const {
+        return (ids_.capacity() + lengthStart_.capacity()) * sizeof(uint32_t) + heads_.capacity() * sizeof(uint64_t);
+    }
+};
@@ -0,0 +1,169 @@
+﻿// CodeQuery.h
+// CS499 – Final ePortfolio Artifact (Advising Assistance Program)
+//
+// Description:
+// Range and prefix queries over course codes, answered from the code
+// order index. Accepted forms (case and spacing are ignored):
+//   MATH               one department
+//   CS*                departments starting with CS (CS, CSCI, ...)
+//   MATH3XX            a level: MATH300 through MATH399
+//   CSCI300            one course number, any suffix (CSCI300, CSCI300L)
+//   CSCI300-CSCI499    an inclusive (department, number) range; the end
+//   CSCI300-499        may omit the department
+//
+// The index is sorted by codeSortKey (CourseCode.h), which orders the
+// department and number in its high bits. A query is turned into the
+// smallest and largest key a match can have, two binary searches find
+// that stretch of the index, and matches() settles the few codes whose
+// keys are not exact (departments over five letters, huge numbers). A
+// query costs O(log n + k) for k results.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "CourseCode.h"
+
+class CodeQuery {
+private:
+    // A (department, number) bound; an empty number spans the department.
+    struct Bound {
+        std::string dept, number;
+    };
+
+    bool prefix_ = false;   // department prefix query (lo_.dept)
+    Bound lo_, hi_;
+    uint64_t keyLo_ = 0, keyHi_ = 0;
+
+    static std::string canonical(std::string_view s) {
+        std::string out(s.size(), '\0');
+        out.resize(canonInto(s, &out[0]));
+        return out;
+    }
+
+    static std::string_view numberValue(std::string_view digits) {
+        return digits.substr(std::min(digits.find_first_not_of('0'), digits.size()));
+    }
+
+    // Orders (dept, number) parts against a bound; an empty bound number
+    // compares equal to every number of its department.
+    static int compare(const CodeParts& p, const Bound& b) {
+        int c = p.dept.compare(b.dept);
+        if (c != 0 || b.number.empty()) return c < 0 ? -1 : c > 0;
+        if (p.number.empty()) return -1;
+        std::string_view x = numberValue(p.number), y = numberValue(b.number);
+        if (x.size() != y.size()) return x.size() < y.size() ? -1 : 1;
+        c = x.compare(y);
+        return c < 0 ? -1 : c > 0;
+    }
+
+    static bool parseBound(std::string_view text, Bound& b, std::string& error) {
+        std::string code = canonical(text);
+        CodeParts p = splitCode(code);
+        if (!p.suffix.empty()) {
+            error = "'" + code + "' is not a department and number (suffixes are not used in ranges)";
+            return false;
+        }
+        b.dept.assign(p.dept);
+        b.number.assign(p.number);
+        return true;
+    }
+
+public:
+    // Parses a query; on failure returns false and sets error.
+    bool parse(std::string_view text, std::string& error) {
+        *this = CodeQuery();
+        std::string_view t = text;
+        while (!t.empty() && (t.front() == ' ' || t.front() == '\t')) t.remove_prefix(1);
+        while (!t.empty() && (t.back() == ' ' || t.back() == '\t' || t.back() == '\r')) t.remove_suffix(1);
+        if (canonical(t).empty()) {
+            error = "empty query";
+            return false;
+        }
+
+        if (t.back() == '*') {
+            std::string dept = canonical(t.substr(0, t.size() - 1));
+            if (!splitCode(dept).number.empty() || !splitCode(dept).suffix.empty()) {
+                error = "a prefix query takes department letters only (e.g. CS*)";
+                return false;
+            }
+            prefix_ = true;
+            lo_.dept = dept;
+            size_t bits = 5 * std::min<size_t>(dept.size(), 5);
+            keyLo_ = codeSortKey(dept);
+            keyHi_ = dept.empty() ? ~0ull
+                : keyLo_ | ((dept.size() <= 5 ? 1ull << (64 - bits) : 1ull << 38) - 1);
+            return true;
+        }
+
+        size_t dash = t.find('-', 1);
+        if (dash != std::string_view::npos) {
+            if (!parseBound(t.substr(0, dash), lo_, error) || !parseBound(t.substr(dash + 1), hi_, error))
+                return false;
+            if (lo_.dept.empty() || (hi_.dept.empty() && hi_.number.empty())) {
+                error = "a range needs a start and an end (e.g. CSCI300-CSCI499)";
+                return false;
+            }
+            if (hi_.dept.empty()) hi_.dept = lo_.dept;
+        }
+        else {
+            std::string code = canonical(t);
+            CodeParts p = splitCode(code);
+            bool level = !p.number.empty() && !p.suffix.empty() &&
+                p.suffix.find_first_not_of('X') == std::string_view::npos;
+            if (level) {
+                // MATH3XX: each X is one wildcard digit.
+                lo_.dept.assign(p.dept);
+                lo_.number = std::string(p.number) + std::string(p.suffix.size(), '0');
+                hi_.dept = lo_.dept;
+                hi_.number = std::string(p.number) + std::string(p.suffix.size(), '9');
+            }
+            else {
+                if (!parseBound(t, lo_, error)) return false;
+                hi_ = lo_;
+            }
+        }
+
+        std::string first = lo_.dept + lo_.number;
+        if (compare(splitCode(first), hi_) > 0) {
+            error = "the range starts after it ends";
+            return false;
+        }
+        keyLo_ = codeSortKey(first);
+        keyHi_ = codeSortKey(hi_.dept + hi_.number) | (hi_.number.empty() ? (1ull << 38) - 1 : 0x3FFF);
+        return true;
+    }
+
+    // Every matching code has a key in [keyLo(), keyHi()].
+    uint64_t keyLo() const { return keyLo_; }
+    uint64_t keyHi() const { return keyHi_; }
+
+    bool matches(std::string_view code) const {
+        CodeParts p = splitCode(code);
+        if (prefix_) return p.dept.substr(0, lo_.dept.size()) == lo_.dept;
+        return compare(p, lo_) >= 0 && compare(p, hi_) <= 0;
+    }
+
+    // Positions [first, last) of a code-ordered sequence of n codes, with
+    // keyAt(i) its sort keys, that can hold matches.
+    template <class KeyAt>
+    std::pair<size_t, size_t> candidates(size_t n, KeyAt&& keyAt) const {
+        auto firstAbove = [&](auto&& below) {
+            size_t lo = 0, hi = n;
+            while (lo < hi) {
+                size_t mid = lo + (hi - lo) / 2;
+                if (below(keyAt(mid))) lo = mid + 1;
+                else hi = mid;
+            }
+            return lo;
+        };
+        size_t first = firstAbove([&](uint64_t k) { return k < keyLo_; });
+        size_t last = firstAbove([&](uint64_t k) { return k <= keyHi_; });
+        return { first, std::max(first, last) };
+    }
+};
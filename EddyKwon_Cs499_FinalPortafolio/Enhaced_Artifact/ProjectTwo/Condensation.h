@@ -0,0 +1,162 @@
+﻿// Condensation.h
+// CS499 – Final ePortfolio Artifact (Advising Assistance Program)
+//
+// Description:
+// The prerequisite graph with every cycle collapsed to a single node. All
+// courses on a cycle require each other, so reachability indexes (see
+// Closure.h, ReachLabels.h) work on the components, which form a DAG.
+//
+// Components are found with Tarjan's algorithm (iteratively, so a long
+// prerequisite chain cannot overflow the call stack) and numbered by their
+// position in a topological order: every edge runs from a smaller position
+// to a larger one. Kahn's algorithm releases the component holding the
+// smallest node first, which keeps positions close to load order.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+class Condensation {
+private:
+    std::vector<uint32_t> component_;   // node -> position
+    std::vector<uint32_t> succStart_;   // positions + 1 into succ_
+    std::vector<uint32_t> succ_;        // positions, ascending and distinct per row
+    std::vector<bool> cyclic_;          // position -> component is a cycle
+
+    // Tarjan's algorithm; sets comp[u] and returns the component count,
+    // numbering components by their smallest node.
+    template <class Successors>
+    static uint32_t tarjan(uint32_t n, Successors& successors, std::vector<uint32_t>& comp) {
+        const uint32_t none = UINT32_MAX;
+        std::vector<uint32_t> index(n, none), low(n), stack;
+        std::vector<std::pair<uint32_t, uint32_t>> call;   // node, next edge
+        comp.assign(n, none);
+        uint32_t visited = 0, found = 0;
+        for (uint32_t s = 0; s < n; ++s) {
+            if (index[s] != none) continue;
+            index[s] = low[s] = visited++;
+            stack.push_back(s);
+            call.emplace_back(s, 0);
+            while (!call.empty()) {
+                const uint32_t u = call.back().first;
+                auto row = successors(u);
+                auto it = row.begin() + call.back().second;
+                if (it != row.end()) {
+                    ++call.back().second;
+                    const uint32_t v = *it;
+                    if (index[v] == none) {
+                        index[v] = low[v] = visited++;
+                        stack.push_back(v);
+                        call.emplace_back(v, 0);
+                    }
+                    else if (comp[v] == none) low[u] = std::min(low[u], index[v]);
+                    continue;
+                }
+                call.pop_back();
+                if (!call.empty()) low[call.back().first] = std::min(low[call.back().first], low[u]);
+                if (low[u] != index[u]) continue;
+                uint32_t w;
+                do {
+                    w = stack.back();
+                    stack.pop_back();
+                    comp[w] = found;
+                } while (w != u);
+                ++found;
+            }
+        }
+
+        std::vector<uint32_t> renumber(found, none);
+        uint32_t next = 0;
+        for (uint32_t u = 0; u < n; ++u) {
+            if (renumber[comp[u]] == none) renumber[comp[u]] = next++;
+            comp[u] = renumber[comp[u]];
+        }
+        return found;
+    }
+
+public:
+    // Condenses a graph with nodes nodes; successors(u) lists u's targets.
+    template <class Successors>
+    void build(size_t nodes, Successors&& successors) {
+        const uint32_t n = (uint32_t)nodes;
+        std::vector<uint32_t> comp;
+        const uint32_t c = tarjan(n, successors, comp);
+
+        // Edges between components, and the cycles (a loop counts).
+        std::vector<uint32_t> start(c + 1, 0), succ;
+        std::vector<bool> cyclic(c, false);
+        for (uint32_t u = 0; u < n; ++u)
+            for (uint32_t v : successors(u)) {
+                if (comp[v] != comp[u]) ++start[comp[u] + 1];
+                else cyclic[comp[u]] = true;
+            }
+        for (uint32_t k = 0; k < c; ++k) start[k + 1] += start[k];
+        succ.resize(start[c]);
+        {
+            std::vector<uint32_t> cursor(start.begin(), start.end() - 1);
+            for (uint32_t u = 0; u < n; ++u)
+                for (uint32_t v : successors(u))
+                    if (comp[v] != comp[u]) succ[cursor[comp[u]]++] = comp[v];
+        }
+
+        // Topological positions, smallest component first among the ready.
+        std::vector<uint32_t> indegree(c, 0), position(c), order;
+        order.reserve(c);
+        for (uint32_t v : succ) ++indegree[v];
+        std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<uint32_t>> ready;
+        for (uint32_t k = 0; k < c; ++k)
+            if (indegree[k] == 0) ready.push(k);
+        while (!ready.empty()) {
+            uint32_t k = ready.top();
+            ready.pop();
+            position[k] = (uint32_t)order.size();
+            order.push_back(k);
+            for (uint32_t i = start[k]; i < start[k + 1]; ++i)
+                if (--indegree[succ[i]] == 0) ready.push(succ[i]);
+        }
+
+        // Rows by position, sorted, repeated edges dropped.
+        component_.resize(n);
+        for (uint32_t u = 0; u < n; ++u) component_[u] = position[comp[u]];
+        cyclic_.assign(c, false);
+        succStart_.assign(1, 0);
+        succ_.clear();
+        succ_.reserve(succ.size());
+        for (uint32_t p = 0; p < c; ++p) {
+            const uint32_t k = order[p];
+            cyclic_[p] = cyclic[k];
+            const size_t first = succ_.size();
+            for (uint32_t i = start[k]; i < start[k + 1]; ++i) succ_.push_back(position[succ[i]]);
+            std::sort(succ_.begin() + first, succ_.end());
+            succ_.erase(std::unique(succ_.begin() + first, succ_.end()), succ_.end());
+            succStart_.push_back((uint32_t)succ_.size());
+        }
+    }
+
+    void clear() {
+        component_.clear();
+        succStart_.clear();
+        succ_.clear();
+        cyclic_.clear();
+    }
+
+    size_t nodes() const { return component_.size(); }
+    uint32_t size() const { return succStart_.empty() ? 0 : (uint32_t)succStart_.size() - 1; }
+    uint32_t component(uint32_t u) const { return component_[u]; }
+    bool cyclic(uint32_t p) const { return cyclic_[p]; }
+
+    const std::vector<uint32_t>& components() const { return component_; }
+    const std::vector<uint32_t>& succStart() const { return succStart_; }
+    const std::vector<uint32_t>& succ() const { return succ_; }
+
+    size_t memoryBytes() const {
+        return (component_.capacity() + succStart_.capacity() + succ_.capacity()) * sizeof(uint32_t) +
+            cyclic_.capacity() / 8;
+    }
+};
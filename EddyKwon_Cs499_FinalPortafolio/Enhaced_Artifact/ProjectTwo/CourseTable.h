@@ -0,0 +1,188 @@
+﻿// CourseTable.h
+// CS499 – Final ePortfolio Artifact (Advising Assistance Program)
+//
+// Description:
+// Column-oriented course storage. Instead of one object per course owning
+// its own title string and prerequisite vector, the table keeps one array
+// per field: course ids, title ranges into a single byte buffer, and
+// prerequisite ranges into a single id buffer. A catalog of any size is a
+// handful of allocations, and scans over the rows touch contiguous memory.
+//
+// Course is a small view (table pointer + row) that reads the columns, so
+// code that used to take a Course object keeps the same accessors.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Interner.h"
+
+class CourseTable;
+
+class Course {
+private:
+    const CourseTable* table_ = nullptr;
+    uint32_t row_ = 0;
+
+public:
+    Course() = default;
+    Course(const CourseTable* table, uint32_t row) : table_(table), row_(row) {}
+
+    // False for the empty view returned by failed lookups.
+    explicit operator bool() const { return table_ != nullptr; }
+
+    uint32_t row() const { return row_; }
+    inline CourseId id() const;
+    inline std::string_view title() const;
+    inline IdSpan prereqs() const;
+};
+
+class CourseTable {
+private:
+    std::vector<CourseId> ids_;
+    std::vector<uint32_t> titleBegin_, titleEnd_;       // into titles_
+    std::vector<uint32_t> prereqBegin_, prereqEnd_;     // into prereqIds_
+    std::string titles_;
+    std::vector<CourseId> prereqIds_;
+    size_t staleTitleBytes_ = 0;    // left behind by redefined rows
+    size_t stalePrereqs_ = 0;
+
+    void store(uint32_t row, std::string_view title, IdSpan prereqs) {
+        titleBegin_[row] = (uint32_t)titles_.size();
+        titles_.append(title);
+        titleEnd_[row] = (uint32_t)titles_.size();
+        prereqBegin_[row] = (uint32_t)prereqIds_.size();
+        prereqIds_.insert(prereqIds_.end(), prereqs.begin(), prereqs.end());
+        prereqEnd_[row] = (uint32_t)prereqIds_.size();
+    }
+
+public:
+    class const_iterator {
+    private:
+        const CourseTable* table_;
+        uint32_t row_;
+
+    public:
+        const_iterator(const CourseTable* table, uint32_t row) : table_(table), row_(row) {}
+        Course operator*() const { return Course(table_, row_); }
+        const_iterator& operator++() { ++row_; return *this; }
+        bool operator==(const const_iterator& o) const { return row_ == o.row_; }
+        bool operator!=(const const_iterator& o) const { return row_ != o.row_; }
+    };
+
+    bool empty() const { return ids_.empty(); }
+    size_t size() const { return ids_.size(); }
+
+    void clear() {
+        ids_.clear();
+        titleBegin_.clear();
+        titleEnd_.clear();
+        prereqBegin_.clear();
+        prereqEnd_.clear();
+        titles_.clear();
+        prereqIds_.clear();
+        staleTitleBytes_ = stalePrereqs_ = 0;
+    }
+
+    void reserve(size_t rows, size_t prereqs = 0) {
+        ids_.reserve(rows);
+        titleBegin_.reserve(rows);
+        titleEnd_.reserve(rows);
+        prereqBegin_.reserve(rows);
+        prereqEnd_.reserve(rows);
+        prereqIds_.reserve(prereqs);
+    }
+
+    // Adds a row and returns its index.
+    uint32_t append(CourseId id, std::string_view title, IdSpan prereqs) {
+        uint32_t row = (uint32_t)ids_.size();
+        ids_.push_back(id);
+        titleBegin_.push_back(0);
+        titleEnd_.push_back(0);
+        prereqBegin_.push_back(0);
+        prereqEnd_.push_back(0);
+        store(row, title, prereqs);
+        return row;
+    }
+
+    // Replaces a row's title and prerequisites. The old values stay in the
+    // buffers until compact().
+    void assign(uint32_t row, std::string_view title, IdSpan prereqs) {
+        staleTitleBytes_ += titleEnd_[row] - titleBegin_[row];
+        stalePrereqs_ += prereqEnd_[row] - prereqBegin_[row];
+        store(row, title, prereqs);
+    }
+
+    // Removes a row by moving the last row into its place (so that row's
+    // index changes). The removed values stay in the buffers until
+    // compact().
+    void erase(uint32_t row) {
+        staleTitleBytes_ += titleEnd_[row] - titleBegin_[row];
+        stalePrereqs_ += prereqEnd_[row] - prereqBegin_[row];
+        ids_[row] = ids_.back();
+        titleBegin_[row] = titleBegin_.back();
+        titleEnd_[row] = titleEnd_.back();
+        prereqBegin_[row] = prereqBegin_.back();
+        prereqEnd_[row] = prereqEnd_.back();
+        ids_.pop_back();
+        titleBegin_.pop_back();
+        titleEnd_.pop_back();
+        prereqBegin_.pop_back();
+        prereqEnd_.pop_back();
+    }
+
+    // Rewrites the buffers in row order, dropping values left behind by
+    // assign() and erase(), and releases spare capacity.
+    void compact() {
+        if (staleTitleBytes_ == 0 && stalePrereqs_ == 0) {
+            titles_.shrink_to_fit();
+            prereqIds_.shrink_to_fit();
+            return;
+        }
+        std::string titles;
+        std::vector<CourseId> prereqIds;
+        titles.reserve(titles_.size() - staleTitleBytes_);
+        prereqIds.reserve(prereqIds_.size() - stalePrereqs_);
+        for (uint32_t r = 0; r < ids_.size(); ++r) {
+            uint32_t tb = (uint32_t)titles.size();
+            titles.append(titles_, titleBegin_[r], titleEnd_[r] - titleBegin_[r]);
+            titleBegin_[r] = tb;
+            titleEnd_[r] = (uint32_t)titles.size();
+            uint32_t pb = (uint32_t)prereqIds.size();
+            prereqIds.insert(prereqIds.end(),
+                prereqIds_.begin() + prereqBegin_[r], prereqIds_.begin() + prereqEnd_[r]);
+            prereqBegin_[r] = pb;
+            prereqEnd_[r] = (uint32_t)prereqIds.size();
+        }
+        titles_.swap(titles);
+        prereqIds_.swap(prereqIds);
+        staleTitleBytes_ = stalePrereqs_ = 0;
+    }
+
+    CourseId id(uint32_t row) const { return ids_[row]; }
+    std::string_view title(uint32_t row) const {
+        return std::string_view(titles_.data() + titleBegin_[row], titleEnd_[row] - titleBegin_[row]);
+    }
+    IdSpan prereqs(uint32_t row) const {
+        return { prereqIds_.data() + prereqBegin_[row], prereqIds_.data() + prereqEnd_[row] };
+    }
+
+    Course operator[](uint32_t row) const { return Course(this, row); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, (uint32_t)ids_.size()); }
+
+    // Bytes held by the columns and buffers.
+    size_t memoryBytes() const {
+        return (ids_.capacity() + titleBegin_.capacity() + titleEnd_.capacity() +
+            prereqBegin_.capacity() + prereqEnd_.capacity() + prereqIds_.capacity()) * sizeof(uint32_t) +
+            titles_.capacity();
+    }
+};
+
+inline CourseId Course::id() const { return table_->id(row_); }
+inline std::string_view Course::title() const { return table_->title(row_); }
+inline IdSpan Course::prereqs() const { return table_->prereqs(row_); }
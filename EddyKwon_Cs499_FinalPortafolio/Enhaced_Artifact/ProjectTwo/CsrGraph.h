@@ -0,0 +1,179 @@
+﻿// CsrGraph.h
+// CS499 – Final ePortfolio Artifact (Advising Assistance Program)
+//
+// Description:
+// Prerequisite graph in compressed-sparse-row form. Node u's forward edges
+// (prerequisite -> courses that require it) are
+// fwdTargets[fwdBegin[u] .. fwdEnd[u]), and the reverse edges (course ->
+// its prerequisites) are stored the same way. A few flat arrays per
+// direction replace one heap vector per course, so traversals walk
+// contiguous memory.
+//
+// The graph is built in two linear passes over the edge list: the first
+// counts degrees (prefix-summed into the row starts), the second scatters
+// the targets into place.
+//
+// Catalog edits patch the graph instead of rebuilding it. A row that grows
+// and is not already last in its array moves to the end first; the slots
+// it leaves behind are reclaimed by repacking once they outnumber the
+// edges. Removing an edge closes the gap and keeps the rest of the row in
+// order.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Interner.h"
+
+class CsrGraph {
+private:
+    // Row u is targets[begin[u] .. end[u]) in each direction.
+    std::vector<uint32_t> fwdBegin_, fwdEnd_;
+    std::vector<CourseId> fwdTargets_;
+    std::vector<uint32_t> revBegin_, revEnd_;
+    std::vector<CourseId> revTargets_;
+    size_t edges_ = 0;
+    size_t garbage_ = 0;    // slots left behind by moved or shrunk rows, both directions
+
+    // Appends x to row u, first moving the row to the end of targets
+    // unless it is already there.
+    void append(std::vector<CourseId>& targets, std::vector<uint32_t>& begin, std::vector<uint32_t>& end,
+        CourseId u, CourseId x) {
+        if (end[u] != targets.size()) {
+            const size_t from = begin[u], n = end[u] - begin[u], to = targets.size();
+            targets.resize(to + n);
+            std::copy_n(targets.begin() + (ptrdiff_t)from, n, targets.begin() + (ptrdiff_t)to);
+            begin[u] = (uint32_t)to;
+            end[u] = (uint32_t)(to + n);
+            garbage_ += n;
+        }
+        targets.push_back(x);
+        ++end[u];
+    }
+
+    // Drops the first x from row u; false if the row has none.
+    bool erase(std::vector<CourseId>& targets, std::vector<uint32_t>& begin, std::vector<uint32_t>& end,
+        CourseId u, CourseId x) {
+        auto first = targets.begin() + begin[u], last = targets.begin() + end[u];
+        auto it = std::find(first, last, x);
+        if (it == last) return false;
+        std::copy(it + 1, last, it);
+        if (end[u]-- == targets.size()) targets.pop_back();
+        else ++garbage_;
+        return true;
+    }
+
+    // Lays the rows out back to back again, in node order.
+    void repack(std::vector<CourseId>& targets, std::vector<uint32_t>& begin, std::vector<uint32_t>& end) {
+        std::vector<CourseId> packed;
+        packed.reserve(edges_);
+        for (size_t u = 0; u < begin.size(); ++u) {
+            const uint32_t at = (uint32_t)packed.size();
+            packed.insert(packed.end(), targets.begin() + begin[u], targets.begin() + end[u]);
+            begin[u] = at;
+            end[u] = (uint32_t)packed.size();
+        }
+        targets.swap(packed);
+    }
+
+public:
+    // forEachEdge(emit) must call emit(from, to) for every edge, and must
+    // produce the same edges in the same order both times it is invoked.
+    // Edges keep that order within each row.
+    template <class ForEachEdge>
+    void build(size_t nodeCount, ForEachEdge&& forEachEdge) {
+        fwdBegin_.assign(nodeCount + 1, 0);
+        revBegin_.assign(nodeCount + 1, 0);
+
+        // Pass 1: degrees.
+        forEachEdge([&](CourseId from, CourseId to) {
+            ++fwdBegin_[from + 1];
+            ++revBegin_[to + 1];
+        });
+        for (size_t i = 0; i < nodeCount; ++i) {
+            fwdBegin_[i + 1] += fwdBegin_[i];
+            revBegin_[i + 1] += revBegin_[i];
+        }
+        fwdEnd_.assign(fwdBegin_.begin() + 1, fwdBegin_.end());
+        revEnd_.assign(revBegin_.begin() + 1, revBegin_.end());
+        fwdBegin_.pop_back();
+        revBegin_.pop_back();
+        edges_ = fwdEnd_.empty() ? 0 : fwdEnd_.back();
+        garbage_ = 0;
+
+        // Pass 2: scatter, using a running cursor per row.
+        fwdTargets_.resize(edges_);
+        revTargets_.resize(edges_);
+        std::vector<uint32_t> fwdPos(fwdBegin_), revPos(revBegin_);
+        forEachEdge([&](CourseId from, CourseId to) {
+            fwdTargets_[fwdPos[from]++] = to;
+            revTargets_[revPos[to]++] = from;
+        });
+    }
+
+    void clear() {
+        fwdBegin_.clear();
+        fwdEnd_.clear();
+        fwdTargets_.clear();
+        revBegin_.clear();
+        revEnd_.clear();
+        revTargets_.clear();
+        edges_ = 0;
+        garbage_ = 0;
+    }
+
+    // Grows the graph to nodeCount nodes; the new ones have no edges.
+    void resize(size_t nodeCount) {
+        if (nodeCount <= fwdBegin_.size()) return;
+        fwdBegin_.resize(nodeCount, (uint32_t)fwdTargets_.size());
+        fwdEnd_.resize(nodeCount, (uint32_t)fwdTargets_.size());
+        revBegin_.resize(nodeCount, (uint32_t)revTargets_.size());
+        revEnd_.resize(nodeCount, (uint32_t)revTargets_.size());
+    }
+
+    // Adds from -> to at the end of both rows; the nodes must exist.
+    void addEdge(CourseId from, CourseId to) {
+        append(fwdTargets_, fwdBegin_, fwdEnd_, from, to);
+        append(revTargets_, revBegin_, revEnd_, to, from);
+        ++edges_;
+        if (garbage_ > 2 * edges_) compact();
+    }
+
+    // Removes one copy of from -> to; false if there is none.
+    bool removeEdge(CourseId from, CourseId to) {
+        if (!erase(fwdTargets_, fwdBegin_, fwdEnd_, from, to)) return false;
+        erase(revTargets_, revBegin_, revEnd_, to, from);
+        --edges_;
+        if (garbage_ > 2 * edges_) compact();
+        return true;
+    }
+
+    // Reclaims the slots edits left behind.
+    void compact() {
+        repack(fwdTargets_, fwdBegin_, fwdEnd_);
+        repack(revTargets_, revBegin_, revEnd_);
+        garbage_ = 0;
+    }
+
+    size_t nodeCount() const { return fwdBegin_.size(); }
+    size_t edgeCount() const { return edges_; }
+
+    IdSpan successors(CourseId u) const {
+        return { fwdTargets_.data() + fwdBegin_[u], fwdTargets_.data() + fwdEnd_[u] };
+    }
+    IdSpan predecessors(CourseId v) const {
+        return { revTargets_.data() + revBegin_[v], revTargets_.data() + revEnd_[v] };
+    }
+
+    uint32_t outdegree(CourseId u) const { return fwdEnd_[u] - fwdBegin_[u]; }
+    uint32_t indegree(CourseId v) const { return revEnd_[v] - revBegin_[v]; }
+
+    // Bytes held by the six arrays.
+    size_t memoryBytes() const {
+        return (fwdBegin_.capacity() + fwdEnd_.capacity() + fwdTargets_.capacity() +
+            revBegin_.capacity() + revEnd_.capacity() + revTargets_.capacity()) * sizeof(uint32_t);
+    }
+};
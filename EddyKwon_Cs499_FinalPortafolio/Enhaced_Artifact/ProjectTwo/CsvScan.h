@@ -0,0 +1,268 @@
+﻿// CsvScan.h
+// CS499 – Final ePortfolio Artifact (Advising Assistance Program)
+//
+// Description:
+// Vectorized CSV structure scanner. A kernel classifies a whole block of
+// input at once and produces (1) the offsets of every ',' and '\n' and
+// (2) a bitmap of whitespace bytes. Field boundaries come straight from
+// the offsets and fields are trimmed with bit scans over the bitmap, so
+// the per-character work of std::getline + trim disappears.
+//
+// Kernels: AVX2 (32 bytes per compare), SSE4.2 (PCMPESTRM character-set
+// match) and a portable scalar fallback. The best supported kernel is
+// picked at runtime from CpuFeatures.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#include "Simd.h"
+
+// Scans p[0, n). Writes the ascending offsets of ',' and '\n' to delims
+// (capacity n) and the whitespace bitmap to space (capacity (n + 63) / 64).
+// Returns the number of offsets written.
+using CsvScanKernel = size_t (*)(const char* p, size_t n, uint32_t* delims, uint64_t* space);
+
+namespace csvscan {
+
+static inline uint32_t* emitBits(uint64_t m, uint32_t base, uint32_t* out) {
+    while (m) {
+        *out++ = base + ctz64(m);
+        m &= m - 1;
+    }
+    return out;
+}
+
+static inline bool isDelim(unsigned char ch) { return ch == ',' || ch == '\n'; }
+static inline bool isSpace(unsigned char ch) { return ch == ' ' || (ch >= '\t' && ch <= '\r'); }
+
+static inline void masks64Scalar(const char* p, uint64_t& delim, uint64_t& space) {
+    delim = 0;
+    space = 0;
+    for (unsigned i = 0; i < 64; ++i) {
+        unsigned char ch = (unsigned char)p[i];
+        delim |= (uint64_t)isDelim(ch) << i;
+        space |= (uint64_t)isSpace(ch) << i;
+    }
+}
+
+static size_t scanScalar(const char* p, size_t n, uint32_t* delims, uint64_t* space) {
+    uint32_t* out = delims;
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        uint64_t d, s;
+        masks64Scalar(p + i, d, s);
+        space[i / 64] = s;
+        out = emitBits(d, (uint32_t)i, out);
+    }
+    if (i < n) {
+        char tail[64] = {};
+        std::memcpy(tail, p + i, n - i);
+        uint64_t d, s;
+        masks64Scalar(tail, d, s);
+        space[i / 64] = s;
+        out = emitBits(d, (uint32_t)i, out);
+    }
+    return (size_t)(out - delims);
+}
+
+#if PT_X86
+PT_TARGET("sse4.2")
+static inline void masks64Sse42(const char* p, uint64_t& delim, uint64_t& space) {
+    const __m128i delimSet = _mm_setr_epi8(',', '\n', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i spaceSet = _mm_setr_epi8(' ', '\t', '\n', '\v', '\f', '\r', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    const int mode = _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_BIT_MASK;
+    delim = 0;
+    space = 0;
+    for (unsigned q = 0; q < 4; ++q) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(p + 16 * q));
+        uint64_t d = (uint16_t)_mm_cvtsi128_si32(_mm_cmpestrm(delimSet, 2, v, 16, mode));
+        uint64_t s = (uint16_t)_mm_cvtsi128_si32(_mm_cmpestrm(spaceSet, 6, v, 16, mode));
+        delim |= d << (16 * q);
+        space |= s << (16 * q);
+    }
+}
+
+PT_TARGET("sse4.2")
+static size_t scanSse42(const char* p, size_t n, uint32_t* delims, uint64_t* space) {
+    uint32_t* out = delims;
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        uint64_t d, s;
+        masks64Sse42(p + i, d, s);
+        space[i / 64] = s;
+        out = emitBits(d, (uint32_t)i, out);
+    }
+    if (i < n) {
+        char tail[64] = {};
+        std::memcpy(tail, p + i, n - i);
+        uint64_t d, s;
+        masks64Sse42(tail, d, s);
+        space[i / 64] = s;
+        out = emitBits(d, (uint32_t)i, out);
+    }
+    return (size_t)(out - delims);
+}
+
+PT_TARGET("avx2")
+static inline void masks64Avx2(const char* p, uint64_t& delim, uint64_t& space) {
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    const __m256i blank = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i four = _mm256_set1_epi8(4);
+    delim = 0;
+    space = 0;
+    for (unsigned h = 0; h < 2; ++h) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(p + 32 * h));
+        __m256i d = _mm256_or_si256(_mm256_cmpeq_epi8(v, comma), _mm256_cmpeq_epi8(v, newline));
+        // '\t'..'\r' is the range [9, 13]: (v - 9) <= 4 as unsigned bytes.
+        __m256i off = _mm256_sub_epi8(v, tab);
+        __m256i ctl = _mm256_cmpeq_epi8(_mm256_min_epu8(off, four), off);
+        __m256i s = _mm256_or_si256(ctl, _mm256_cmpeq_epi8(v, blank));
+        delim |= (uint64_t)(uint32_t)_mm256_movemask_epi8(d) << (32 * h);
+        space |= (uint64_t)(uint32_t)_mm256_movemask_epi8(s) << (32 * h);
+    }
+}
+
+PT_TARGET("avx2")
+static size_t scanAvx2(const char* p, size_t n, uint32_t* delims, uint64_t* space) {
+    uint32_t* out = delims;
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        uint64_t d, s;
+        masks64Avx2(p + i, d, s);
+        space[i / 64] = s;
+        out = emitBits(d, (uint32_t)i, out);
+    }
+    if (i < n) {
+        char tail[64] = {};
+        std::memcpy(tail, p + i, n - i);
+        uint64_t d, s;
+        masks64Avx2(tail, d, s);
+        space[i / 64] = s;
+        out = emitBits(d, (uint32_t)i, out);
+    }
+    return (size_t)(out - delims);
+}
+#endif
+
+} // namespace csvscan
+
+struct CsvKernelInfo {
+    const char* name;
+    CsvScanKernel fn;
+    bool supported;
+};
+
+// All kernels compiled into this build, fastest first.
+static inline std::vector<CsvKernelInfo> csvKernels() {
+    std::vector<CsvKernelInfo> ks;
+#if PT_X86
+    ks.push_back({ "avx2", csvscan::scanAvx2, CpuFeatures::get().avx2 });
+    ks.push_back({ "sse4.2", csvscan::scanSse42, CpuFeatures::get().sse42 });
+#endif
+    ks.push_back({ "scalar", csvscan::scanScalar, true });
+    return ks;
+}
+
+static inline CsvScanKernel activeCsvKernel() {
+    static const CsvScanKernel k = [] {
+        for (const auto& info : csvKernels())
+            if (info.supported) return info.fn;
+        return (CsvScanKernel)csvscan::scanScalar;
+    }();
+    return k;
+}
+
+// -----------------------------------------------------------------------------
+// Record iteration on top of a scan kernel
+// -----------------------------------------------------------------------------
+class CsvScanner {
+private:
+    CsvScanKernel kernel_;
+    size_t blockSize_;
+    std::vector<uint32_t> delims_;
+    std::vector<uint64_t> space_;
+
+    // Trims [a, b) of the current block using the whitespace bitmap.
+    // A UTF-8 BOM at the start of a field is dropped first, like stripBOM.
+    std::string_view field(const char* base, size_t a, size_t b) const {
+        if (b - a >= 3 && (unsigned char)base[a] == 0xEF &&
+            (unsigned char)base[a + 1] == 0xBB && (unsigned char)base[a + 2] == 0xBF) a += 3;
+        while (a < b) {
+            uint64_t w = ~space_[a >> 6] >> (a & 63);
+            if (w) { a += ctz64(w); break; }
+            a = (a | 63) + 1;
+        }
+        if (a > b) a = b;
+        while (b > a) {
+            size_t i = b - 1;
+            uint64_t w = ~space_[i >> 6] << (63 - (i & 63));
+            if (w) { b = i + 1 - (63 - msb64(w)); break; }
+            b = i & ~(size_t)63;
+        }
+        if (b < a) b = a;
+        return std::string_view(base + a, b - a);
+    }
+
+public:
+    explicit CsvScanner(CsvScanKernel kernel = activeCsvKernel(), size_t blockSize = 64 * 1024)
+        : kernel_(kernel), blockSize_(blockSize) {}
+
+    // Calls onRecord(line, fields) for every line of buf in order. `line`
+    // excludes the "\r\n" terminator. Fields are trimmed and follow the
+    // splitCSV rules: a trailing empty field after the last comma is dropped.
+    template <class OnRecord>
+    void forEachRecord(std::string_view buf, std::vector<std::string_view>& fields, OnRecord&& onRecord) {
+        size_t start = 0;
+        size_t block = blockSize_;
+
+        while (start < buf.size()) {
+            size_t n = std::min(block, buf.size() - start);
+            if (delims_.size() < n) delims_.resize(n);
+            if (space_.size() < (n + 63) / 64) space_.resize((n + 63) / 64);
+
+            const char* base = buf.data() + start;
+            size_t count = kernel_(base, n, delims_.data(), space_.data());
+            bool last = start + n == buf.size();
+
+            size_t lineStart = 0, fieldStart = 0;
+            fields.clear();
+            auto finishLine = [&](size_t end) {
+                if (end > lineStart && base[end - 1] == '\r') --end;
+                if (fieldStart < end) fields.push_back(field(base, fieldStart, end));
+                onRecord(std::string_view(base + lineStart, end - lineStart), fields);
+                fields.clear();
+            };
+
+            for (size_t k = 0; k < count; ++k) {
+                size_t d = delims_[k];
+                if (base[d] == ',') {
+                    fields.push_back(field(base, fieldStart, d));
+                    fieldStart = d + 1;
+                }
+                else {
+                    finishLine(d);
+                    lineStart = fieldStart = d + 1;
+                }
+            }
+
+            if (last) {
+                if (lineStart < n) finishLine(n);
+                break;
+            }
+            if (lineStart == 0) {
+                // A single line longer than the block: rescan with a bigger one.
+                block *= 2;
+                continue;
+            }
+            start += lineStart;
+        }
+    }
+};
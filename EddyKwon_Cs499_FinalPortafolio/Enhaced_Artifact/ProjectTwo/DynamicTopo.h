@@ -0,0 +1,456 @@
+﻿// DynamicTopo.h
+// CS499 – Final ePortfolio Artifact (Advising Assistance Program)
+//
+// Description:
+// A topological order that survives edits. Rerunning Kahn's algorithm
+// after every added or removed prerequisite costs the whole graph; this
+// keeps the order and repairs only what an edit invalidates (Pearce and
+// Kelly's dynamic topological sort).
+//
+// Removing an edge, or adding one that already runs forward in the order,
+// changes nothing. An edge x -> y that runs backward only disturbs the
+// nodes placed between y and x: the ones y leads to and the ones that
+// lead to x. Those are found with two searches bounded by that window,
+// and swap places: x's side takes the lowest of their positions, y's side
+// the rest, each keeping its internal order. Finding x from y means the
+// edge would close a cycle; it is rejected before anything changes.
+//
+// Nodes are dense ids; the graph may have repeated edges (a prerequisite
+// listed twice), and removeEdge() drops one copy.
+//
+// The order kept is always a valid one, but which one depends on the
+// edits made, not only on the graph: build() seeds it by rank, and edits
+// then move only what they must. Its use is the cycle check.
+//
+// RankedTopoOrder keeps the order that is shown: the one Kahn's algorithm
+// gives when the ready node of smallest rank always goes next, which
+// depends on the graph alone. An edit cannot change it before the first
+// position where a node the edit touched stood, or where that node could
+// now be ready and outrank the node placed there. From that position the
+// greedy pass is replayed until it has placed the same nodes as the old
+// order (less any removed, plus any added), and only that window is
+// rewritten. The replay takes nodes straight from the old order; only the
+// touched nodes and those the edit holds up or frees early go through a
+// heap.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "KahnFrontier.h"
+
+class DynamicTopoOrder {
+private:
+    std::vector<uint32_t> pos_;     // node -> position
+    std::vector<uint32_t> at_;      // position -> node
+    std::vector<std::vector<uint32_t>> out_, in_;
+    bool valid_ = false;
+
+    // Search state, reused across edits.
+    std::vector<uint32_t> mark_;
+    uint32_t round_ = 0;
+    std::vector<uint32_t> forward_, backward_, stack_, slots_;
+    size_t lastMoved_ = 0;
+
+    bool visit(uint32_t u) {
+        if (mark_[u] == round_) return false;
+        mark_[u] = round_;
+        return true;
+    }
+
+    static bool eraseOne(std::vector<uint32_t>& row, uint32_t v) {
+        auto it = std::find(row.begin(), row.end(), v);
+        if (it == row.end()) return false;
+        *it = row.back();
+        row.pop_back();
+        return true;
+    }
+
+public:
+    // Orders nodes nodes by Kahn's algorithm; forEachEdge(emit) calls
+    // emit(u, v) for every edge u -> v, and ready nodes leave smallest
+    // rank(u) first (then smallest id). Returns false, leaving the order
+    // empty, if the graph has a cycle.
+    template <class ForEachEdge, class Rank>
+    bool build(size_t nodes, ForEachEdge&& forEachEdge, Rank&& rank) {
+        clear();
+        const uint32_t n = (uint32_t)nodes;
+        out_.resize(n);
+        in_.resize(n);
+        forEachEdge([&](uint32_t u, uint32_t v) {
+            out_[u].push_back(v);
+            in_[v].push_back(u);
+        });
+
+        std::vector<uint32_t> indegree(n);
+        for (uint32_t u = 0; u < n; ++u) indegree[u] = (uint32_t)in_[u].size();
+        DaryHeap<4> ready;
+        at_.reserve(n);
+        if (kahnSort(ready, n, [](uint32_t) { return true; }, indegree,
+                [&](uint32_t u) -> const std::vector<uint32_t>& { return out_[u]; },
+                [&](uint32_t u) { return (uint64_t)rank(u) << 32 | u; }, at_) != n) {
+            clear();
+            return false;
+        }
+        pos_.assign(n, 0);
+        for (uint32_t i = 0; i < n; ++i) pos_[at_[i]] = i;
+        mark_.assign(n, 0);
+        valid_ = true;
+        return true;
+    }
+
+    void clear() {
+        pos_.clear();
+        at_.clear();
+        out_.clear();
+        in_.clear();
+        mark_.clear();
+        round_ = 0;
+        valid_ = false;
+    }
+
+    // False until a build() succeeds.
+    bool valid() const { return valid_; }
+    size_t size() const { return at_.size(); }
+
+    // Grows the graph to nodes nodes; new nodes have no edges and go last.
+    void resize(size_t nodes) {
+        while (at_.size() < nodes) {
+            const uint32_t u = (uint32_t)at_.size();
+            pos_.push_back(u);
+            at_.push_back(u);
+            out_.emplace_back();
+            in_.emplace_back();
+            mark_.push_back(0);
+        }
+    }
+
+    // Adds u -> v and repairs the order. Returns false, changing nothing,
+    // if v already leads to u (or u == v): the edge would close a cycle.
+    bool addEdge(uint32_t u, uint32_t v) {
+        lastMoved_ = 0;
+        if (u == v) return false;
+        const uint32_t lower = pos_[v], upper = pos_[u];
+        if (lower < upper) {
+            if (++round_ == 0) {
+                std::fill(mark_.begin(), mark_.end(), 0);
+                round_ = 1;
+            }
+
+            // What v leads to inside the window; reaching u is a cycle.
+            forward_.clear();
+            stack_.assign(1, v);
+            visit(v);
+            while (!stack_.empty()) {
+                const uint32_t x = stack_.back();
+                stack_.pop_back();
+                forward_.push_back(x);
+                for (uint32_t y : out_[x]) {
+                    if (y == u) return false;
+                    if (pos_[y] < upper && visit(y)) stack_.push_back(y);
+                }
+            }
+
+            // What leads to u inside the window.
+            backward_.clear();
+            stack_.assign(1, u);
+            visit(u);
+            while (!stack_.empty()) {
+                const uint32_t x = stack_.back();
+                stack_.pop_back();
+                backward_.push_back(x);
+                for (uint32_t y : in_[x])
+                    if (pos_[y] > lower && visit(y)) stack_.push_back(y);
+            }
+
+            // u's side first, then v's, on the positions they held.
+            auto byPosition = [&](uint32_t a, uint32_t b) { return pos_[a] < pos_[b]; };
+            std::sort(forward_.begin(), forward_.end(), byPosition);
+            std::sort(backward_.begin(), backward_.end(), byPosition);
+            slots_.clear();
+            for (uint32_t x : backward_) slots_.push_back(pos_[x]);
+            for (uint32_t x : forward_) slots_.push_back(pos_[x]);
+            std::inplace_merge(slots_.begin(), slots_.begin() + (ptrdiff_t)backward_.size(), slots_.end());
+            size_t i = 0;
+            for (uint32_t x : backward_) at_[pos_[x] = slots_[i++]] = x;
+            for (uint32_t x : forward_) at_[pos_[x] = slots_[i++]] = x;
+            lastMoved_ = slots_.size();
+        }
+        out_[u].push_back(v);
+        in_[v].push_back(u);
+        return true;
+    }
+
+    // Removes one copy of u -> v; false if there is none. The order stays
+    // valid as it is.
+    bool removeEdge(uint32_t u, uint32_t v) {
+        if (!eraseOne(out_[u], v)) return false;
+        eraseOne(in_[v], u);
+        return true;
+    }
+
+    uint32_t position(uint32_t u) const { return pos_[u]; }
+    uint32_t at(size_t position) const { return at_[position]; }
+    const std::vector<uint32_t>& successors(uint32_t u) const { return out_[u]; }
+
+    // Nodes the last addEdge() moved (0 when the edge already ran forward).
+    size_t lastMoved() const { return lastMoved_; }
+
+    size_t memoryBytes() const {
+        size_t bytes = (pos_.capacity() + at_.capacity() + mark_.capacity() + forward_.capacity() +
+            backward_.capacity() + stack_.capacity() + slots_.capacity()) * sizeof(uint32_t) +
+            (out_.capacity() + in_.capacity()) * sizeof(std::vector<uint32_t>);
+        for (const auto& row : out_) bytes += row.capacity() * sizeof(uint32_t);
+        for (const auto& row : in_) bytes += row.capacity() * sizeof(uint32_t);
+        return bytes;
+    }
+};
+
+class RankedTopoOrder {
+private:
+    static constexpr uint32_t npos = UINT32_MAX;
+
+    std::vector<uint32_t> at_;      // position -> node
+    std::vector<uint32_t> pos_;     // node -> position, npos if not placed
+    bool valid_ = false;
+
+    // Repair state, reused across edits. A node's flags and count are
+    // current while its mark equals round_.
+    enum : uint8_t { kTouched = 1, kNew = 2, kOld = 4, kCounted = 8 };
+    std::vector<uint32_t> mark_, count_;
+    std::vector<uint8_t> flags_;
+    uint32_t round_ = 0;
+    std::vector<uint32_t> heap_, window_;
+    size_t lastWindow_ = 0;
+
+    uint8_t& flags(uint32_t u) {
+        if (mark_[u] != round_) {
+            mark_[u] = round_;
+            flags_[u] = 0;
+        }
+        return flags_[u];
+    }
+
+public:
+    // Orders the ready nodes of nodes nodes by Kahn's algorithm, smallest
+    // rank(u) first; indegree(u) and successors(u) describe the graph, whose
+    // edges join ready nodes only. Returns false, leaving the order
+    // invalid, if the graph has a cycle.
+    template <class Ready, class Indegree, class Successors, class Rank>
+    bool build(size_t nodes, Ready&& ready, Indegree&& indegree, Successors&& successors, Rank&& rank) {
+        clear();
+        const uint32_t n = (uint32_t)nodes;
+        std::vector<uint32_t> remaining(n);
+        size_t readyCount = 0;
+        for (uint32_t u = 0; u < n; ++u) {
+            remaining[u] = indegree(u);
+            readyCount += ready(u);
+        }
+        DaryHeap<4> frontier;
+        if (kahnSort(frontier, n, ready, remaining, successors, [&](uint32_t u) { return (uint64_t)rank(u); }, at_) !=
+            readyCount) {
+            clear();
+            return false;
+        }
+        pos_.assign(n, npos);
+        for (uint32_t i = 0; i < at_.size(); ++i) pos_[at_[i]] = i;
+        mark_.assign(n, 0);
+        count_.resize(n);
+        flags_.resize(n);
+        valid_ = true;
+        return true;
+    }
+
+    void clear() {
+        at_.clear();
+        pos_.clear();
+        mark_.clear();
+        count_.clear();
+        flags_.clear();
+        round_ = 0;
+        valid_ = false;
+    }
+
+    // False until a build() succeeds, and after a repair() meets a cycle.
+    bool valid() const { return valid_; }
+    const std::vector<uint32_t>& order() const { return at_; }
+
+    // Repairs the order after an edit to the graph. touched lists every
+    // node whose incoming edges changed or that became or stopped being
+    // ready; ready, predecessors and successors describe the graph after
+    // the edit, nodes bounds its ids, and less(a, b) must order nodes as
+    // the ranks build() was given. Returns false, leaving the order
+    // invalid, if the edit closed a cycle.
+    template <class Ready, class Predecessors, class Successors, class Less>
+    bool repair(size_t nodes, const std::vector<uint32_t>& touched, Ready&& ready, Predecessors&& predecessors,
+        Successors&& successors, Less&& less) {
+        if (!valid_) return false;
+        if (pos_.size() < nodes) {
+            pos_.resize(nodes, npos);
+            mark_.resize(nodes, 0);
+            count_.resize(nodes);
+            flags_.resize(nodes);
+        }
+        if (++round_ == 0) {
+            std::fill(mark_.begin(), mark_.end(), 0);
+            round_ = 1;
+        }
+        const uint32_t size = (uint32_t)at_.size();
+
+        // The first position the edit can change.
+        uint32_t first = size;
+        for (uint32_t x : touched) {
+            if (pos_[x] != npos) first = std::min(first, pos_[x]);
+            if (!ready(x)) continue;
+            uint32_t t = 0;
+            for (uint32_t p : predecessors(x)) t = std::max(t, pos_[p] == npos ? size : pos_[p] + 1);
+            while (t < first && less(at_[t], x)) ++t;
+            first = std::min(first, t);
+        }
+
+        // The new side has placed a node once it is before first or marked
+        // kNew; old counts the old order's nodes the replay has passed.
+        uint32_t old = first;
+        auto placed = [&](uint32_t p) { return pos_[p] < first || (flags(p) & kNew); };
+        auto unplaced = [&](uint32_t u) {
+            uint32_t n = 0;
+            for (uint32_t p : predecessors(u)) n += !placed(p);
+            return n;
+        };
+        auto later = [&](uint32_t a, uint32_t b) { return less(b, a); };
+        auto push = [&](uint32_t u) {
+            heap_.push_back(u);
+            std::push_heap(heap_.begin(), heap_.end(), later);
+        };
+        // Counts u's unplaced prerequisites and tracks it on the heap.
+        auto track = [&](uint32_t u, uint8_t& f) {
+            f |= kCounted;
+            if ((count_[u] = unplaced(u)) == 0) push(u);
+        };
+
+        // Touched nodes are tracked from the start. A removed node counts
+        // as placed on the new side and an added one as passed on the old,
+        // so diff (nodes placed on one side only) reaches 0 when both sides
+        // have placed the same nodes.
+        heap_.clear();
+        window_.clear();
+        int64_t diff = 0;
+        size_t left = 0;    // touched ready nodes not yet placed
+        for (uint32_t x : touched) {
+            uint8_t& f = flags(x);
+            if (f & kTouched) continue;
+            f |= kTouched;
+            if (!ready(x)) {
+                if (pos_[x] != npos) {
+                    f |= kNew;
+                    ++diff;
+                }
+                continue;
+            }
+            if (pos_[x] == npos) {
+                f |= kOld;
+                ++diff;
+            }
+            ++left;
+            track(x, f);
+        }
+
+        // The next untracked node of the old order with every prerequisite
+        // placed. Untracked nodes have the prerequisites they had, all of
+        // them placed in the old order's sequence, so this one outranks
+        // every other untracked node that is ready: the old pass chose it
+        // over them. Nodes passed that wait on one still unplaced are
+        // tracked instead.
+        uint32_t candidate = npos;
+        auto nextFromOld = [&]() {
+            for (; old < size; ++old) {
+                const uint32_t x = at_[old];
+                uint8_t& f = flags(x);
+                if (!(f & (kTouched | kCounted | kNew))) {
+                    bool free = true;
+                    for (uint32_t p : predecessors(x))
+                        if (!placed(p)) {
+                            free = false;
+                            break;
+                        }
+                    if (free) {
+                        candidate = x;
+                        return;
+                    }
+                    track(x, f);
+                }
+                f |= kOld;
+                diff += (f & kNew) ? -1 : 1;
+                if (diff == 0 && left == 0) {
+                    ++old;
+                    break;
+                }
+            }
+            candidate = npos;
+        };
+
+        for (;;) {
+            if (diff == 0 && left == 0) break;
+            if (candidate == npos) nextFromOld();
+            if (diff == 0 && left == 0) break;  // passing caught the old side up
+            uint32_t u;
+            if (!heap_.empty() && (candidate == npos || less(heap_.front(), candidate))) {
+                std::pop_heap(heap_.begin(), heap_.end(), later);
+                u = heap_.back();
+                heap_.pop_back();
+            }
+            else if (candidate != npos) {
+                u = candidate;
+                candidate = npos;
+                flags(u) |= kOld;
+                ++diff;
+                ++old;
+            }
+            else {
+                clear();
+                return false;
+            }
+            // A node placed ahead of the old order releases its successors
+            // early, so they are tracked too.
+            const bool ahead = pos_[u] >= old;
+            for (uint32_t v : successors(u)) {
+                uint8_t& g = flags(v);
+                if (!(g & kCounted)) {
+                    if (!ahead || (g & kNew)) continue;
+                    track(v, g);
+                }
+                if (--count_[v] == 0) push(v);
+            }
+            uint8_t& f = flags(u);
+            f |= kNew;
+            diff += (f & kOld) ? -1 : 1;
+            left -= (f & kTouched) != 0;
+            window_.push_back(u);
+        }
+
+        // Rewrite the window; the rest moves only when its length changed.
+        for (uint32_t i = first; i < old; ++i) pos_[at_[i]] = npos;
+        uint32_t last = old;
+        if (window_.size() == old - first) std::copy(window_.begin(), window_.end(), at_.begin() + first);
+        else {
+            at_.erase(at_.begin() + first, at_.begin() + old);
+            at_.insert(at_.begin() + first, window_.begin(), window_.end());
+            last = (uint32_t)at_.size();
+        }
+        for (uint32_t i = first; i < last; ++i) pos_[at_[i]] = i;
+        lastWindow_ = window_.size();
+        return true;
+    }
+
+    // Nodes the last repair() placed afresh.
+    size_t lastWindow() const { return lastWindow_; }
+
+    size_t memoryBytes() const {
+        return (at_.capacity() + pos_.capacity() + mark_.capacity() + count_.capacity() + heap_.capacity() +
+            window_.capacity()) * sizeof(uint32_t) + flags_.capacity();
+    }
+};
@@ -0,0 +1,257 @@
+﻿// FuzzyIndex.h
+// CS499 – Final ePortfolio Artifact (Advising Assistance Program)
+//
+// Description:
+// Typo-tolerant code lookup: the course codes within a small Levenshtein
+// distance of a code that was not found ("CSIC300" -> CSCI300).
+//
+// EditPattern computes the distance from one pattern to many texts with
+// Myers' bit-parallel algorithm: the pattern's columns live in the bits of
+// a 64-bit word, so each text byte costs a handful of word operations
+// instead of a row of the dynamic-programming table. Patterns longer than
+// 64 bytes use the plain two-row DP.
+//
+// FuzzyIndex is a BK-tree over the codes. Each child hangs off its parent
+// under its distance to the parent, and the triangle inequality limits a
+// search for codes within r of q to the children whose edge lies within r
+// of d(q, node), so most of the tree is never visited. The tree is stored
+// flat in breadth-first order: node i's children are the nodes
+// [childStart[i], childStart[i + 1]), sorted by edge. The tree keeps its
+// own copy of the codes in node order, so a search reads neighbouring
+// bytes instead of chasing each id into the catalog.
+//
+// FuzzyView evaluates over borrowed arrays (a FuzzyIndex's own vectors or
+// sections of a mapped snapshot), like PerfectHashView.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Edit distance allowed when suggesting codes: one edit for short codes,
+// two (e.g. a swapped pair of letters) otherwise.
+static inline uint32_t fuzzyRadius(std::string_view code) {
+    return code.size() <= 4 ? 1 : 2;
+}
+
+class EditPattern {
+private:
+    std::string_view pattern_;
+    uint64_t peq_[256];     // bit i set where pattern_[i] is the byte
+
+    static uint32_t rowDistance(std::string_view a, std::string_view b) {
+        std::vector<uint32_t> row(a.size() + 1);
+        for (size_t i = 0; i <= a.size(); ++i) row[i] = (uint32_t)i;
+        for (size_t j = 1; j <= b.size(); ++j) {
+            uint32_t diag = row[0];
+            row[0] = (uint32_t)j;
+            for (size_t i = 1; i <= a.size(); ++i) {
+                uint32_t up = row[i];
+                row[i] = std::min({ row[i] + 1, row[i - 1] + 1, diag + (a[i - 1] != b[j - 1]) });
+                diag = up;
+            }
+        }
+        return row[a.size()];
+    }
+
+public:
+    explicit EditPattern(std::string_view pattern) : pattern_(pattern) {
+        std::memset(peq_, 0, sizeof(peq_));
+        if (pattern.size() <= 64)
+            for (size_t i = 0; i < pattern.size(); ++i) peq_[(unsigned char)pattern[i]] |= 1ull << i;
+    }
+
+    // Levenshtein distance from the pattern to text.
+    uint32_t distance(std::string_view text) const {
+        const size_t m = pattern_.size();
+        if (m == 0) return (uint32_t)text.size();
+        if (m > 64) return rowDistance(pattern_, text);
+
+        // pv/mv: vertical +1/-1 deltas of the current column; score is the
+        // bottom cell, i.e. the distance to the text read so far.
+        const uint64_t last = 1ull << (m - 1);
+        uint64_t pv = ~0ull, mv = 0;
+        uint32_t score = (uint32_t)m;
+        for (unsigned char c : text) {
+            uint64_t eq = peq_[c];
+            uint64_t xv = eq | mv;
+            uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+            uint64_t ph = mv | ~(xh | pv);
+            uint64_t mh = pv & xh;
+            if (ph & last) ++score;
+            else if (mh & last) --score;
+            ph = ph << 1 | 1;   // the top row grows by one per text byte
+            mh <<= 1;
+            pv = mh | ~(xv | ph);
+            mv = ph & xv;
+        }
+        return score;
+    }
+};
+
+struct FuzzyView {
+    const uint32_t* ids = nullptr;          // nodes, breadth-first
+    const uint32_t* edges = nullptr;        // nodes: distance to the parent
+    const uint32_t* childStart = nullptr;   // nodes + 1
+    const uint32_t* codeOffsets = nullptr;  // nodes + 1, into codeBytes
+    const char* codeBytes = nullptr;        // node codes, in node order
+    uint32_t nodes = 0;
+
+    bool empty() const { return nodes == 0; }
+
+    std::string_view code(uint32_t node) const {
+        return std::string_view(codeBytes + codeOffsets[node], codeOffsets[node + 1] - codeOffsets[node]);
+    }
+
+    // Calls fn(id, distance) for every code within radius of query, in no
+    // particular order.
+    template <class Fn>
+    void within(std::string_view query, uint32_t radius, Fn&& fn) const {
+        if (nodes == 0) return;
+        EditPattern pattern(query);
+        std::vector<uint32_t> stack{ 0 };
+        while (!stack.empty()) {
+            uint32_t n = stack.back();
+            stack.pop_back();
+            uint32_t d = pattern.distance(code(n));
+            if (d <= radius) fn(ids[n], d);
+            const uint32_t* first = edges + childStart[n];
+            const uint32_t* last = edges + childStart[n + 1];
+            for (const uint32_t* e = std::lower_bound(first, last, d > radius ? d - radius : 0); e < last && *e <= d + radius; ++e)
+                stack.push_back((uint32_t)(e - edges));
+        }
+    }
+
+    // Up to k (id, distance) pairs within radius of query, closest first
+    // and then by before(a, b) on the ids.
+    template <class Before>
+    std::vector<std::pair<uint32_t, uint32_t>> nearest(std::string_view query, uint32_t radius, size_t k,
+        Before&& before) const {
+        std::vector<std::pair<uint32_t, uint32_t>> out;
+        within(query, radius, [&](uint32_t id, uint32_t d) { out.emplace_back(id, d); });
+        k = std::min(k, out.size());
+        std::partial_sort(out.begin(), out.begin() + k, out.end(), [&](const auto& x, const auto& y) {
+            return x.second != y.second ? x.second < y.second : before(x.first, y.first);
+        });
+        out.resize(k);
+        return out;
+    }
+};
+
+class FuzzyIndex {
+private:
+    std::vector<uint32_t> ids_, edges_, childStart_, codeOffsets_;
+    std::string codeBytes_;
+
+public:
+    // Indexes the codes of ids (which must be distinct); codeAt(id) gives
+    // each one's code.
+    //
+    // Built top-down, breadth-first: a node takes the first code of its
+    // subtree, the rest are grouped by their distance to it (one pass of
+    // EditPattern over the group), and each group becomes a child in edge
+    // order. The codes are copied once and move with their ids as groups
+    // are split, so every pass reads contiguous bytes.
+    template <class CodeAt>
+    void build(const std::vector<uint32_t>& ids, CodeAt&& codeAt) {
+        clear();
+        if (ids.empty()) return;
+        const size_t n = ids.size();
+
+        // Position i holds work[i], whose code is bytes[at[i], at[i + 1]).
+        // Node q's subtree is positions [range[q].first, range[q].second),
+        // its own code first; its children's subtrees split up the rest.
+        std::vector<uint32_t> work(ids), at(n + 1, 0);
+        std::string bytes;
+        for (size_t i = 0; i < n; ++i) {
+            bytes.append(codeAt(ids[i]));
+            at[i + 1] = (uint32_t)bytes.size();
+        }
+        std::vector<uint32_t> dist(n), dest(n), newWork(n), newAt(n + 1), count;
+        std::string newBytes(bytes.size(), '\0');
+        auto codeAtPos = [&](uint32_t i) { return std::string_view(bytes.data() + at[i], at[i + 1] - at[i]); };
+
+        std::vector<std::pair<uint32_t, uint32_t>> range{ { 0, (uint32_t)n } };
+        edges_.push_back(0);
+        childStart_.push_back(1);
+        codeOffsets_.push_back(0);
+        for (uint32_t q = 0; q < range.size(); ++q) {
+            const uint32_t b = range[q].first, e = range[q].second;
+            ids_.push_back(work[b]);
+            codeBytes_.append(codeAtPos(b));
+            codeOffsets_.push_back((uint32_t)codeBytes_.size());
+
+            EditPattern pattern(codeAtPos(b));
+            uint32_t maxDist = 0;
+            for (uint32_t i = b + 1; i < e; ++i) {
+                dist[i] = pattern.distance(codeAtPos(i));
+                maxDist = std::max(maxDist, dist[i]);
+            }
+            count.assign((size_t)maxDist + 2, 0);
+            for (uint32_t i = b + 1; i < e; ++i) ++count[dist[i] + 1];
+            for (uint32_t d = 0; d <= maxDist; ++d) count[d + 1] += count[d];
+
+            // Stable regroup of positions (b, e) by distance, ids and bytes.
+            for (uint32_t i = b + 1; i < e; ++i) {
+                dest[i] = b + 1 + count[dist[i]]++;
+                newWork[dest[i]] = work[i];
+                newAt[dest[i] + 1] = at[i + 1] - at[i];
+            }
+            newAt[b + 1] = at[b + 1];
+            for (uint32_t p = b + 1; p < e; ++p) newAt[p + 1] += newAt[p];
+            for (uint32_t i = b + 1; i < e; ++i)
+                std::memcpy(&newBytes[newAt[dest[i]]], bytes.data() + at[i], at[i + 1] - at[i]);
+            std::memcpy(&bytes[at[b + 1]], newBytes.data() + at[b + 1], at[e] - at[b + 1]);
+            std::copy(newWork.begin() + b + 1, newWork.begin() + e, work.begin() + b + 1);
+            std::copy(newAt.begin() + b + 1, newAt.begin() + e, at.begin() + b + 1);
+
+            // Each non-empty group past distance 0 (a repeated code, which
+            // is dropped) becomes a child.
+            for (uint32_t d = 1, start = b + 1 + count[0]; d <= maxDist; ++d) {
+                uint32_t end = b + 1 + count[d];
+                if (end > start) {
+                    edges_.push_back(d);
+                    range.emplace_back(start, end);
+                }
+                start = end;
+            }
+            childStart_.push_back((uint32_t)range.size());
+        }
+    }
+
+    void clear() {
+        ids_.clear();
+        edges_.clear();
+        childStart_.clear();
+        codeOffsets_.clear();
+        codeBytes_.clear();
+    }
+
+    FuzzyView view() const {
+        FuzzyView v;
+        v.ids = ids_.data();
+        v.edges = edges_.data();
+        v.childStart = childStart_.data();
+        v.codeOffsets = codeOffsets_.data();
+        v.codeBytes = codeBytes_.data();
+        v.nodes = (uint32_t)ids_.size();
+        return v;
+    }
+
+    const std::vector<uint32_t>& ids() const { return ids_; }
+    const std::vector<uint32_t>& edges() const { return edges_; }
+    const std::vector<uint32_t>& childStart() const { return childStart_; }
+    const std::vector<uint32_t>& codeOffsets() const { return codeOffsets_; }
+    const std::string& codeBytes() const { return codeBytes_; }
+
+    size_t memoryBytes() const {
+        return (ids_.capacity() + edges_.capacity() + childStart_.capacity() + codeOffsets_.capacity()) * sizeof(uint32_t) +
+            codeBytes_.capacity();
+    }
+};
@@ -0,0 +1,258 @@
+﻿// Interner.h
+// CS499 – Final ePortfolio Artifact (Advising Assistance Program)
+//
+// Description:
+// String interning table for canonical course codes. Every distinct code
+// gets a dense uint32_t CourseId the first time it is seen, so the rest of
+// the program (prerequisite lists, graph, traversal) works on integers and
+// only turns ids back into strings when printing. The code text itself is
+// kept in one contiguous buffer indexed by id.
+//
+// Lookups go through a flat open-addressing table (Robin Hood, linear
+// probing). Each 16-byte slot holds a 32-bit hash, the id and the code's
+// position in the buffer; a probe reads consecutive slots and only touches
+// the code bytes when hash and length match. The slot array comes from a
+// monotonic arena owned by the interner, so clear() drops it without
+// per-entry work.
+//
+// freeze() swaps the probing table for a minimal perfect hash once the key
+// set is final: a lookup is then one hash evaluation and one id read,
+// with no probe sequence. The next intern() thaws the interner again.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "CourseCode.h"
+#include "PerfectHash.h"
+
+using CourseId = uint32_t;
+static const CourseId kNoCourse = UINT32_MAX;
+
+// Read-only range of ids inside a contiguous array (graph rows, snapshot
+// sections, prerequisite lists).
+struct IdSpan {
+    const CourseId* first = nullptr;
+    const CourseId* last = nullptr;
+
+    const CourseId* begin() const { return first; }
+    const CourseId* end() const { return last; }
+    size_t size() const { return (size_t)(last - first); }
+    bool empty() const { return first == last; }
+    CourseId operator[](size_t i) const { return first[i]; }
+};
+
+class CodeInterner {
+private:
+    // All codes back to back in one buffer; code i is [ends_[i - 1], ends_[i]).
+    std::string bytes_;
+    std::vector<uint32_t> ends_;
+
+    // id == kNoCourse marks an empty slot. A slot's home is hash & mask_.
+    struct Slot {
+        uint32_t hash;
+        CourseId id;
+        uint32_t offset;    // code bytes are bytes_[offset, offset + length)
+        uint32_t length;
+    };
+    std::pmr::monotonic_buffer_resource arena_{ 64 * 1024 };
+    Slot* slots_ = nullptr;
+    size_t mask_ = 0;
+
+    // Frozen lookup: frozen_[perfect_(codeHash(code))] is the only
+    // candidate for code. Entries carry the code's position so a hit reads
+    // the entry and the code bytes, not ends_.
+    struct FrozenEntry {
+        CourseId id;
+        uint32_t offset;
+        uint32_t length;
+    };
+    PerfectHash perfect_;
+    std::vector<FrozenEntry> frozenEntries_;
+    bool frozen_ = false;
+
+    static uint32_t hash32(std::string_view code) { return (uint32_t)codeHash(code); }
+
+    std::string_view view(CourseId id) const {
+        uint32_t b = id ? ends_[id - 1] : 0;
+        return std::string_view(bytes_.data() + b, ends_[id] - b);
+    }
+
+    size_t capacity() const { return slots_ ? mask_ + 1 : 0; }
+
+    // Robin Hood insert of a key known to be absent: an entry closer to its
+    // home than the one being placed gives up its slot and moves on.
+    void place(Slot cur) {
+        size_t pos = cur.hash & mask_;
+        for (size_t dist = 0;; pos = (pos + 1) & mask_, ++dist) {
+            Slot& s = slots_[pos];
+            if (s.id == kNoCourse) {
+                s = cur;
+                return;
+            }
+            size_t sdist = (pos - s.hash) & mask_;
+            if (sdist < dist) {
+                std::swap(s, cur);
+                dist = sdist;
+            }
+        }
+    }
+
+    // Grows to at least `want` slots (power of two). The old array stays
+    // in the arena until the next clear().
+    void rehash(size_t want) {
+        size_t cap = 16;
+        while (cap < want) cap *= 2;
+        Slot* old = slots_;
+        size_t oldCap = capacity();
+        slots_ = (Slot*)arena_.allocate(cap * sizeof(Slot), alignof(Slot));
+        mask_ = cap - 1;
+        std::fill(slots_, slots_ + cap, Slot{ 0, kNoCourse, 0, 0 });
+        for (size_t i = 0; i < oldCap; ++i)
+            if (old[i].id != kNoCourse) place(old[i]);
+    }
+
+    // Back to the probing table, rebuilt from the code buffer.
+    void thaw() {
+        frozen_ = false;
+        perfect_.clear();
+        frozenEntries_ = std::vector<FrozenEntry>();
+        slots_ = nullptr;
+        mask_ = 0;
+        arena_.release();
+        rehash(ends_.size() * 8 / 7 + 1);
+        uint32_t offset = 0;
+        for (CourseId id = 0; id < ends_.size(); ++id) {
+            std::string_view code = view(id);
+            place(Slot{ hash32(code), id, offset, (uint32_t)code.size() });
+            offset = ends_[id];
+        }
+    }
+
+    // Slot index holding code, or SIZE_MAX.
+    size_t locate(std::string_view code, uint32_t h) const {
+        if (!slots_) return SIZE_MAX;
+        size_t pos = h & mask_;
+        for (size_t dist = 0;; pos = (pos + 1) & mask_, ++dist) {
+            const Slot& s = slots_[pos];
+            if (s.id == kNoCourse || ((pos - s.hash) & mask_) < dist) return SIZE_MAX;
+            if (s.hash == h && s.length == code.size() &&
+                std::memcmp(bytes_.data() + s.offset, code.data(), code.size()) == 0)
+                return pos;
+        }
+    }
+
+public:
+    CodeInterner() = default;
+    CodeInterner(const CodeInterner&) = delete;
+    CodeInterner& operator=(const CodeInterner&) = delete;
+
+    // Returns the id of code, assigning the next free id on first sight.
+    CourseId intern(std::string_view code) {
+        if (frozen_) {
+            CourseId known = find(code);
+            if (known != kNoCourse) return known;
+            thaw();
+        }
+        uint32_t h = hash32(code);
+        size_t pos = locate(code, h);
+        if (pos != SIZE_MAX) return slots_[pos].id;
+
+        // Keep the load factor at or below 7/8.
+        if ((ends_.size() + 1) * 8 > capacity() * 7) rehash(capacity() * 2);
+        CourseId id = (CourseId)ends_.size();
+        uint32_t offset = (uint32_t)bytes_.size();
+        bytes_.append(code);
+        ends_.push_back((uint32_t)bytes_.size());
+        place(Slot{ h, id, offset, (uint32_t)code.size() });
+        return id;
+    }
+
+    // kNoCourse when the code has never been interned.
+    CourseId find(std::string_view code) const {
+        if (frozen_) {
+            if (ends_.empty()) return kNoCourse;
+            const FrozenEntry& e = frozenEntries_[perfect_(codeHash(code))];
+            return e.length == code.size() &&
+                std::memcmp(bytes_.data() + e.offset, code.data(), code.size()) == 0 ? e.id : kNoCourse;
+        }
+        size_t pos = locate(code, hash32(code));
+        return pos == SIZE_MAX ? kNoCourse : slots_[pos].id;
+    }
+
+    // Valid until the next intern().
+    std::string_view name(CourseId id) const { return view(id); }
+    size_t size() const { return ends_.size(); }
+
+    void reserve(size_t n) {
+        ends_.reserve(n);
+        if (!frozen_ && n * 8 > capacity() * 7) rehash(n * 8 / 7 + 1);
+    }
+
+    // Builds the perfect hash over the current codes and releases the
+    // probing table. Returns false (and stays unfrozen) if the build fails.
+    bool freeze() {
+        if (frozen_) return true;
+        PerfectHash ph;
+        if (!ph.build((uint32_t)ends_.size(), [&](uint32_t id) { return codeHash(view(id)); })) return false;
+        frozenEntries_.assign(ends_.size(), FrozenEntry{ kNoCourse, 0, 0 });
+        uint32_t offset = 0;
+        for (CourseId id = 0; id < ends_.size(); ++id) {
+            std::string_view code = view(id);
+            frozenEntries_[ph(codeHash(code))] = FrozenEntry{ id, offset, (uint32_t)code.size() };
+            offset = ends_[id];
+        }
+        perfect_ = std::move(ph);
+        slots_ = nullptr;
+        mask_ = 0;
+        arena_.release();
+        frozen_ = true;
+        return true;
+    }
+
+    bool frozen() const { return frozen_; }
+
+    // O(1) in the number of codes: the slot array is abandoned with the arena.
+    void clear() {
+        frozen_ = false;
+        perfect_.clear();
+        frozenEntries_.clear();
+        slots_ = nullptr;
+        mask_ = 0;
+        arena_.release();
+        ends_.clear();
+        bytes_.clear();
+    }
+
+    // Mean and longest distance of the entries from their home slots.
+    struct ProbeStats {
+        double mean = 0;
+        size_t max = 0;
+    };
+    ProbeStats probeStats() const {
+        ProbeStats st;
+        size_t total = 0;
+        for (size_t pos = 0; pos < capacity(); ++pos) {
+            if (slots_[pos].id == kNoCourse) continue;
+            size_t d = (pos - slots_[pos].hash) & mask_;
+            total += d;
+            st.max = std::max(st.max, d);
+        }
+        if (!ends_.empty()) st.mean = (double)total / ends_.size();
+        return st;
+    }
+
+    // Bytes held by the code buffer, offsets and the live lookup structure.
+    size_t memoryBytes() const {
+        return bytes_.capacity() + ends_.capacity() * sizeof(uint32_t) + capacity() * sizeof(Slot) +
+            perfect_.memoryBytes() + frozenEntries_.capacity() * sizeof(FrozenEntry);
+    }
+};
@@ -0,0 +1,166 @@
+﻿// KahnFrontier.h
+// CS499 – Final ePortfolio Artifact (Advising Assistance Program)
+//
+// Description:
+// Kahn's topological sort with the frontier (the ready, zero-indegree
+// nodes) as a policy. Which ready node leaves first decides the order;
+// the frontier is told each node's sort key when it is pushed, and the
+// caller picks the key (see TieBreak in ProjectTwo.cpp):
+//
+//   DaryHeap<D>   smallest key first. A D-ary heap over (key, node) pairs
+//                 is shallower than a binary heap and a sift-down compares
+//                 siblings that share a cache line.
+//   BucketQueue   key = (bucket << 32) | tie, smallest bucket first, for
+//                 small monotone buckets such as course levels: Kahn
+//                 releases a node only after every node of a lower level,
+//                 so when the queue moves on to a bucket it is complete,
+//                 and it is sorted by tie once. Pushes are O(1).
+//   FifoFrontier  release order, key ignored; the cheapest frontier, and
+//                 the baseline for what the others cost.
+//
+// Each offers empty(), push(node, key) and pop(); clear() empties it for
+// reuse without releasing memory.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+template <unsigned D>
+class DaryHeap {
+    static_assert(D >= 2, "a heap needs at least two children per node");
+
+private:
+    // Keys and nodes side by side: sifting compares keys only.
+    std::vector<uint64_t> keys_;
+    std::vector<uint32_t> nodes_;
+
+public:
+    bool empty() const { return keys_.empty(); }
+    size_t size() const { return keys_.size(); }
+
+    void clear() {
+        keys_.clear();
+        nodes_.clear();
+    }
+
+    void push(uint32_t node, uint64_t key) {
+        size_t i = keys_.size();
+        keys_.emplace_back();
+        nodes_.emplace_back();
+        while (i > 0) {
+            const size_t parent = (i - 1) / D;
+            if (keys_[parent] <= key) break;
+            keys_[i] = keys_[parent];
+            nodes_[i] = nodes_[parent];
+            i = parent;
+        }
+        keys_[i] = key;
+        nodes_[i] = node;
+    }
+
+    uint32_t pop() {
+        const uint32_t top = nodes_.front();
+        const uint64_t key = keys_.back();
+        const uint32_t node = nodes_.back();
+        keys_.pop_back();
+        nodes_.pop_back();
+        const size_t n = keys_.size();
+        if (n == 0) return top;
+
+        size_t i = 0;
+        for (;;) {
+            const size_t first = i * D + 1;
+            if (first >= n) break;
+            size_t best = first;
+            for (size_t c = first + 1; c < std::min(first + D, n); ++c)
+                if (keys_[c] < keys_[best]) best = c;
+            if (key <= keys_[best]) break;
+            keys_[i] = keys_[best];
+            nodes_[i] = nodes_[best];
+            i = best;
+        }
+        keys_[i] = key;
+        nodes_[i] = node;
+        return top;
+    }
+};
+
+class BucketQueue {
+private:
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> buckets_;  // tie, node
+    size_t current_ = 0;    // bucket being popped
+    size_t next_ = 0;       // its next entry
+    size_t size_ = 0;
+
+public:
+    bool empty() const { return size_ == 0; }
+    size_t size() const { return size_; }
+
+    void clear() {
+        for (auto& b : buckets_) b.clear();
+        current_ = next_ = size_ = 0;
+    }
+
+    // Once popping has started, the bucket must be above the one being
+    // popped.
+    void push(uint32_t node, uint64_t key) {
+        const size_t bucket = (size_t)(key >> 32);
+        if (bucket >= buckets_.size()) buckets_.resize(bucket + 1);
+        buckets_[bucket].emplace_back((uint32_t)key, node);
+        ++size_;
+    }
+
+    uint32_t pop() {
+        while (next_ == buckets_[current_].size()) {
+            buckets_[current_].clear();
+            ++current_;
+            next_ = 0;
+        }
+        if (next_ == 0) std::sort(buckets_[current_].begin(), buckets_[current_].end());
+        --size_;
+        return buckets_[current_][next_++].second;
+    }
+};
+
+class FifoFrontier {
+private:
+    std::vector<uint32_t> queue_;
+    size_t head_ = 0;
+
+public:
+    bool empty() const { return head_ == queue_.size(); }
+    size_t size() const { return queue_.size() - head_; }
+
+    void clear() {
+        queue_.clear();
+        head_ = 0;
+    }
+
+    void push(uint32_t node, uint64_t) { queue_.push_back(node); }
+    uint32_t pop() { return queue_[head_++]; }
+};
+
+// Appends a topological order of the nodes to order: ready(u) says which
+// nodes may enter the frontier (those that do not are never output),
+// indegree holds every node's incoming edge count and is used up, and
+// successors(u) lists u's targets. Returns the number of nodes output;
+// fewer than the ready ones means a cycle.
+template <class Frontier, class Ready, class Successors, class Key>
+static size_t kahnSort(Frontier& frontier, size_t nodes, Ready&& ready, std::vector<uint32_t>& indegree,
+    Successors&& successors, Key&& key, std::vector<uint32_t>& order) {
+    const size_t first = order.size();
+    frontier.clear();
+    for (uint32_t u = 0; u < nodes; ++u)
+        if (ready(u) && indegree[u] == 0) frontier.push(u, key(u));
+    while (!frontier.empty()) {
+        const uint32_t u = frontier.pop();
+        order.push_back(u);
+        for (uint32_t v : successors(u))
+            if (--indegree[v] == 0) frontier.push(v, key(v));
+    }
+    return order.size() - first;
+}
@@ -0,0 +1,116 @@
+﻿// LevelOrder.h
+// CS499 – Final ePortfolio Artifact (Advising Assistance Program)
+//
+// Description:
+// Topological sort one level at a time, so large graphs can be ordered
+// on every core. Level 0 holds the nodes nothing points to; level k + 1
+// holds the nodes whose last incoming edge comes from level k. A node's
+// level is the length of the longest chain ending at it, which for the
+// catalog means the earliest term a course can be taken.
+//
+// Kahn's algorithm releases one node at a time. Here a whole level is the
+// frontier: it is cut into chunks that threads take from a ThreadPool;
+// each walks its nodes' edges, decrements the targets' indegrees
+// atomically, and collects the targets that reach zero in the chunk's own
+// list. Exactly one decrement sees a node reach zero, so every node is
+// collected once. The lists are then copied, in chunk order, behind the
+// level as the next frontier. Small levels run on the calling thread.
+//
+// Which chunk releases a node depends on thread timing, so within a level
+// the order varies from run to run; sortLevels() sorts each level by a
+// rank to make it deterministic.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "RadixSort.h"
+#include "ThreadPool.h"
+
+class LevelOrder {
+private:
+    std::vector<uint32_t> order_;       // nodes, level by level
+    std::vector<uint32_t> levelStart_;  // levels + 1 into order_
+    std::vector<uint32_t> level_;       // node -> level (UINT32_MAX if never released)
+
+    // Frontiers smaller than this are not worth waking the pool for.
+    static const size_t kParallelMin = 4096;
+
+public:
+    // Sorts a graph with nodes nodes; indegree(v) counts v's incoming
+    // edges and successors(u) lists u's targets (repeats allowed, counted
+    // once per listing). Levels run on pool when there is one and they are
+    // large enough. Returns false if a cycle stopped the sort; the nodes
+    // released before it are kept.
+    template <class Indegree, class Successors>
+    bool build(size_t nodes, Indegree&& indegree, Successors&& successors, ThreadPool* pool = nullptr) {
+        const uint32_t n = (uint32_t)nodes;
+        std::vector<std::atomic<uint32_t>> remaining(n);
+        order_.clear();
+        order_.reserve(n);
+        levelStart_.assign(1, 0);
+        level_.assign(n, UINT32_MAX);
+        for (uint32_t v = 0; v < n; ++v) {
+            remaining[v].store(indegree(v), std::memory_order_relaxed);
+            if (indegree(v) == 0) order_.push_back(v);
+        }
+
+        std::vector<std::vector<uint32_t>> next;
+        std::vector<size_t> offset;
+        for (uint32_t depth = 0; levelStart_.back() < order_.size(); ++depth) {
+            const size_t begin = levelStart_.back(), end = order_.size();
+            levelStart_.push_back((uint32_t)end);
+            const size_t chunks = end - begin >= kParallelMin ? radix::chunkCount(pool) : 1;
+            if (next.size() < chunks) next.resize(chunks);
+            radix::forChunks(chunks > 1 ? pool : nullptr, end - begin, chunks, [&](size_t c, size_t b, size_t e) {
+                std::vector<uint32_t>& out = next[c];
+                for (size_t i = begin + b; i < begin + e; ++i) {
+                    const uint32_t u = order_[i];
+                    level_[u] = depth;
+                    for (uint32_t v : successors(u))
+                        if (remaining[v].fetch_sub(1, std::memory_order_relaxed) == 1) out.push_back(v);
+                }
+            });
+
+            offset.assign(chunks + 1, end);
+            for (size_t c = 0; c < chunks; ++c) offset[c + 1] = offset[c] + next[c].size();
+            order_.resize(offset[chunks]);
+            auto copy = [&](size_t c) {
+                std::copy(next[c].begin(), next[c].end(), order_.begin() + (ptrdiff_t)offset[c]);
+                next[c].clear();
+            };
+            if (chunks > 1) pool->parallelFor(chunks, copy);
+            else copy(0);
+        }
+        return order_.size() == n;
+    }
+
+    // Sorts every level by rank(u), smallest first, on pool when there is
+    // one. Ranks should be distinct within a level: ties keep the order the
+    // threads left them in.
+    template <class Rank>
+    void sortLevels(Rank&& rank, ThreadPool* pool = nullptr) {
+        radixSortByU64(order_, [&](uint32_t u) { return (uint64_t)level_[u] << 32 | rank(u); }, pool);
+    }
+
+    void clear() {
+        order_.clear();
+        levelStart_.clear();
+        level_.clear();
+    }
+
+    // Nodes released; fewer than the graph's when it has a cycle.
+    size_t size() const { return order_.size(); }
+    uint32_t levels() const { return levelStart_.empty() ? 0 : (uint32_t)levelStart_.size() - 1; }
+    const std::vector<uint32_t>& order() const { return order_; }
+    const std::vector<uint32_t>& levelStart() const { return levelStart_; }
+    uint32_t level(uint32_t u) const { return level_[u]; }
+
+    size_t memoryBytes() const {
+        return (order_.capacity() + levelStart_.capacity() + level_.capacity()) * sizeof(uint32_t);
+    }
+};
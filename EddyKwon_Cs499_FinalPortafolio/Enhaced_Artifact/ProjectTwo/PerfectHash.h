@@ -0,0 +1,178 @@
+﻿// PerfectHash.h
+// CS499 – Final ePortfolio Artifact (Advising Assistance Program)
+//
+// Description:
+// Minimal perfect hash over a fixed key set (hash-and-displace, in the
+// style of CHD/PTHash). Keys are split into buckets of about four; each
+// bucket stores one "pilot" value, chosen at build time so that every key
+// of the bucket lands on a free position. Positions are drawn from a
+// table slightly larger than the key set (load ~0.97), and the few keys
+// that land past the end are sent to the unused positions below n through
+// a small remap array, so the result is a bijection onto [0, n).
+//
+// A lookup is one bucket read, one mix and (rarely) one remap read; there
+// are no collision chains. Keys outside the set also map somewhere in
+// [0, n), so callers verify the key stored at that position.
+//
+// The functions work on 64-bit key hashes (codeHash), so the same pilots
+// can be rebuilt in memory or read back from a snapshot file.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mph {
+
+static inline uint64_t mix(uint64_t x) {
+    x ^= x >> 31;
+    x *= 0x7FB5D329728EA185ull;
+    x ^= x >> 27;
+    x *= 0x81DADEF4BC2DD44Dull;
+    return x ^ (x >> 33);
+}
+
+// Maps the high 32 bits of x onto [0, n) without a division.
+static inline uint32_t fastRange(uint64_t x, uint32_t n) {
+    return (uint32_t)(((x >> 32) * n) >> 32);
+}
+
+// Buckets use the low half of the key hash; positions mix the whole hash.
+static inline uint32_t bucket(uint64_t h, uint32_t buckets) {
+    return (uint32_t)(((h & 0xFFFFFFFFull) * buckets) >> 32);
+}
+
+static inline uint32_t position(uint64_t h, uint32_t pilot, uint32_t tableSize) {
+    return fastRange(mix(h ^ ((uint64_t)pilot * 0x9E3779B97F4A7C15ull)), tableSize);
+}
+
+} // namespace mph
+
+// Evaluation over borrowed arrays: either a PerfectHash's own vectors or
+// sections of a mapped snapshot.
+struct PerfectHashView {
+    const uint32_t* pilots = nullptr;
+    const uint32_t* remap = nullptr;
+    uint32_t buckets = 0;
+    uint32_t keys = 0;          // n; results are in [0, n)
+    uint32_t tableSize = 0;     // n + remap entries
+
+    bool empty() const { return keys == 0; }
+
+    uint32_t operator()(uint64_t h) const {
+        uint32_t p = mph::position(h, pilots[mph::bucket(h, buckets)], tableSize);
+        return p < keys ? p : remap[p - keys];
+    }
+};
+
+class PerfectHash {
+private:
+    std::vector<uint32_t> pilots_;
+    std::vector<uint32_t> remap_;
+    uint32_t keys_ = 0;
+
+    static const uint32_t kMaxPilot = 1u << 22;
+
+public:
+    // Builds over hashAt(i) for i in [0, n). Returns false (and stays
+    // empty) if two keys share a 64-bit hash or no pilot fits a bucket.
+    template <class HashAt>
+    bool build(uint32_t n, HashAt&& hashAt) {
+        clear();
+        if (n == 0) return true;
+
+        std::vector<uint64_t> hashes(n);
+        for (uint32_t i = 0; i < n; ++i) hashes[i] = hashAt(i);
+        {
+            std::vector<uint64_t> sorted(hashes);
+            std::sort(sorted.begin(), sorted.end());
+            if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end()) return false;
+        }
+
+        uint32_t buckets = std::max<uint32_t>(1, (n + 3) / 4);
+        uint32_t tableSize = n + n / 32 + 1;
+
+        // Keys grouped by bucket (CSR: bucketStart + members).
+        std::vector<uint32_t> bucketOf(n), bucketStart(buckets + 1, 0), members(n);
+        for (uint32_t i = 0; i < n; ++i) {
+            bucketOf[i] = mph::bucket(hashes[i], buckets);
+            ++bucketStart[bucketOf[i] + 1];
+        }
+        for (uint32_t b = 0; b < buckets; ++b) bucketStart[b + 1] += bucketStart[b];
+        {
+            std::vector<uint32_t> cursor(bucketStart.begin(), bucketStart.end() - 1);
+            for (uint32_t i = 0; i < n; ++i) members[cursor[bucketOf[i]]++] = i;
+        }
+
+        // Largest buckets first, while the table is still mostly empty.
+        std::vector<uint32_t> order(buckets);
+        for (uint32_t b = 0; b < buckets; ++b) order[b] = b;
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+            return bucketStart[a + 1] - bucketStart[a] > bucketStart[b + 1] - bucketStart[b];
+        });
+
+        std::vector<uint64_t> taken((tableSize + 63) / 64, 0);
+        auto isTaken = [&](uint32_t p) { return (taken[p >> 6] >> (p & 63)) & 1; };
+        std::vector<uint32_t> pilots(buckets, 0), placed;
+        for (uint32_t b : order) {
+            uint32_t first = bucketStart[b], last = bucketStart[b + 1];
+            if (first == last) continue;
+            uint32_t pilot = 0;
+            for (; pilot < kMaxPilot; ++pilot) {
+                placed.clear();
+                bool fits = true;
+                for (uint32_t k = first; k < last && fits; ++k) {
+                    uint32_t p = mph::position(hashes[members[k]], pilot, tableSize);
+                    fits = !isTaken(p) && std::find(placed.begin(), placed.end(), p) == placed.end();
+                    placed.push_back(p);
+                }
+                if (fits) break;
+            }
+            if (pilot == kMaxPilot) return false;
+            pilots[b] = pilot;
+            for (uint32_t p : placed) taken[p >> 6] |= 1ull << (p & 63);
+        }
+
+        // Positions past n are redirected to the holes left below n.
+        std::vector<uint32_t> remap(tableSize - n, 0);
+        uint32_t hole = 0;
+        for (uint32_t p = n; p < tableSize; ++p) {
+            if (!isTaken(p)) continue;
+            while (isTaken(hole)) ++hole;
+            remap[p - n] = hole++;
+        }
+
+        pilots_.swap(pilots);
+        remap_.swap(remap);
+        keys_ = n;
+        return true;
+    }
+
+    void clear() {
+        pilots_.clear();
+        remap_.clear();
+        keys_ = 0;
+    }
+
+    bool empty() const { return keys_ == 0; }
+    uint32_t size() const { return keys_; }
+
+    PerfectHashView view() const {
+        PerfectHashView v;
+        v.pilots = pilots_.data();
+        v.remap = remap_.data();
+        v.buckets = (uint32_t)pilots_.size();
+        v.keys = keys_;
+        v.tableSize = keys_ + (uint32_t)remap_.size();
+        return v;
+    }
+
+    uint32_t operator()(uint64_t h) const { return view()(h); }
+
+    const std::vector<uint32_t>& pilots() const { return pilots_; }
+    const std::vector<uint32_t>& remap() const { return remap_; }
+
+    size_t memoryBytes() const { return (pilots_.capacity() + remap_.capacity()) * sizeof(uint32_t); }
+};
@@ -13,219 +13,629 @@
 //  - M2: Class encapsulation, safer input handling, data validation.
 //  - M3: Directed graph & topological sort (Kahn’s algorithm).
 //  - M5: Added SQLite database connection (demonstrating DB skills).
+//  - Memory-mapped, zero-copy CSV loader with load timing.
+//  - Parallel chunked ingest on a thread pool (--threads N).
+//  - SIMD delimiter scanning (AVX2/SSE4.2/scalar) and --bench microbenchmarks.
+//  - Encoding detection with a vectorized UTF-16 -> UTF-8 ingest path.
+//  - Binary catalog snapshots served straight from a memory mapping.
+//  - Interned integer course ids for prerequisites, graph and traversal.
+//  - Compressed-sparse-row prerequisite graph (forward and reverse edges).
+//  - Column-oriented CourseTable storage with a lightweight Course view.
+//  - Arena-backed code lookup so clearing or reloading a catalog is O(1).
+//  - Table-driven, locale-free course code canonicalization (SIMD for long input).
+//  - Open-addressing (Robin Hood) code lookup with a short-key string hash.
+//  - Optional minimal-perfect-hash "freeze" of the lookup (--freeze), saved in snapshots.
+//  - Persistent code-order index; course list streams in batches or pages (--page N).
+//  - Parallel MSD radix sort of course codes for the order index.
+//  - Natural code order (CSCI200 before CSCI1000) via packed integer sort keys.
+//  - Range/level/prefix course queries (menu 8, --query with --csv/--snapshot).
+//  - Course code autocompletion (--complete, "Did you mean" on lookups).
+//  - Compressed inverted index for ranked title search (menu 10, --search).
+//  - Typo-tolerant lookups: BK-tree with a bit-parallel edit distance.
+//  - Reverse-prerequisite "unlocks" queries for impact analysis (menu 11, --unlocks).
+//  - Transitive-closure bitsets: "is X required for Y" in one bit test (menu 12, --requires).
+//  - Interval reachability labels for catalogs too large for the closure, stored in snapshots.
+//  - Course and prerequisite edits with an incrementally kept order (menu 13, --edit, --order).
+//  - Courses grouped by level with a parallel level-by-level sort (menu 14, --levels).
+//  - Pluggable Kahn frontiers and tie-breaks for the recommended order (--order-by).
+//
+// The catalog and its loader live in Catalog.h, the benchmarks in Bench.cpp
+// (--bench NAME) and the self-tests in Tests.cpp (--test NAME).
 
 #include <algorithm>
-#include <cctype>
-#include <fstream>
+#include <chrono>
+#include <cstdio>
 #include <iostream>
-#include <queue>
-#include <set>
-#include <sstream>
 #include <string>
+#include <string_view>
 #include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
 // Include SQLite (no external install required for demonstration)
 #include <sqlite3.h>
 
+#include "Bench.h"
+#include "Catalog.h"
+#include "CodeQuery.h"
+#include "Snapshot.h"
+
 // -----------------------------------------------------------------------------
-// String helpers
+// Output helpers
 // -----------------------------------------------------------------------------
-static inline void ltrim(std::string& s) {
-    s.erase(s.begin(), std::find_if(s.begin(), s.end(),
-        [](unsigned char ch) { return !std::isspace(ch); }));
+
+// Emits a listing in batches of formatted rows. With pageSize > 0 it stops
+// after each page and asks whether to continue.
+template <class NextBatch>
+static void streamListing(size_t pageSize, NextBatch&& nextBatch) {
+    const size_t batch = pageSize ? pageSize : 4096;
+    std::string out;
+    while (true) {
+        out.clear();
+        bool more = nextBatch(batch, out);
+        std::cout << out;
+        if (!more) break;
+        if (pageSize) {
+            std::cout << "-- more (Enter to continue, q to stop) -- ";
+            std::string reply;
+            if (!std::getline(std::cin, reply)) break;
+            trim(reply);
+            if (reply == "q" || reply == "Q") break;
+        }
+    }
+    std::cout.flush();
 }
-static inline void rtrim(std::string& s) {
-    s.erase(std::find_if(s.rbegin(), s.rend(),
-        [](unsigned char ch) { return !std::isspace(ch); }).base(), s.end());
+
+static void printCourseList(const Catalog& catalog, size_t pageSize = 0) {
+    if (catalog.empty()) {
+        std::cout << "No data loaded.\n";
+        return;
+    }
+
+    std::cout << "Course List:\n";
+    CourseCursor cursor(catalog);
+    streamListing(pageSize, [&](size_t n, std::string& out) {
+        cursor.next(n, [&](Course c) {
+            out.append(catalog.code(c.id())).append(", ").append(c.title()).push_back('\n');
+        });
+        return !cursor.done();
+    });
 }
-static inline void trim(std::string& s) { ltrim(s); rtrim(s); }
 
-static inline void stripBOM(std::string& s) {
-    if (s.size() >= 3 &&
-        (unsigned char)s[0] == 0xEF && (unsigned char)s[1] == 0xBB && (unsigned char)s[2] == 0xBF) {
-        s.erase(0, 3);
+// Courses matching a range/prefix query (see CodeQuery.h), in code order.
+static void printCodeQuery(const Catalog& catalog, const std::string& text, size_t pageSize = 0) {
+    CodeQuery query;
+    std::string error;
+    if (!query.parse(text, error)) {
+        std::cout << "Invalid query: " << error << ".\n";
+        return;
     }
+
+    auto range = query.candidates(catalog.size(), [&](size_t i) { return catalog.orderedKey(i); });
+    size_t pos = range.first, found = 0;
+    std::cout << "Courses matching " << trimView(text) << ":\n";
+    streamListing(pageSize, [&](size_t n, std::string& out) {
+        for (size_t k = 0; k < n && pos < range.second; ++pos) {
+            Course c = catalog.ordered(pos);
+            if (!query.matches(catalog.code(c.id()))) continue;
+            out.append(catalog.code(c.id())).append(", ").append(c.title()).push_back('\n');
+            ++k;
+            ++found;
+        }
+        return pos < range.second;
+    });
+    std::cout << found << (found == 1 ? " course.\n" : " courses.\n");
 }
 
-static std::string canonCode(std::string s) {
-    stripBOM(s);
-    trim(s);
+// Suggestions offered when a course is not found.
+static const size_t kSuggestions = 5;
+
+// "Did you mean" list for a code that was not found: up to kSuggestions
+// codes with their titles, the nearest by edit distance (typos such as
+// CSIC300) or, when none are close, completions of the longest prefix
+// that has any.
+// nearest(code, k, fn) and complete(prefix, k, fn) call fn(code, title)
+// for each match.
+template <class Nearest, class Complete>
+static void printSuggestions(const std::string& canonical, Nearest&& nearest, Complete&& complete) {
+    size_t shown = 0;
     std::string out;
-    out.reserve(s.size());
-    for (unsigned char ch : s) {
-        if (std::isalnum(ch)) out.push_back((char)std::toupper(ch));
-    }
-    return out;
+    auto add = [&](std::string_view code, std::string_view title) {
+        out.append("  ").append(code).append(", ").append(title).push_back('\n');
+        ++shown;
+    };
+    if (!canonical.empty()) nearest(canonical, kSuggestions, add);
+    for (size_t len = canonical.size(); len > 0 && shown == 0; --len)
+        complete(std::string_view(canonical).substr(0, len), kSuggestions, add);
+    if (!out.empty()) std::cout << "Did you mean:\n" << out;
 }
 
-static std::vector<std::string> splitCSV(const std::string& line) {
-    std::vector<std::string> parts;
-    std::string field;
-    std::istringstream ss(line);
-    while (std::getline(ss, field, ',')) {
-        stripBOM(field);
-        trim(field);
-        parts.push_back(field);
+static void printNotFound(const Catalog& catalog, const std::string& canonical) {
+    std::cout << "Course not found.\n";
+    printSuggestions(canonical,
+        [&](std::string_view code, size_t k, auto&& fn) {
+            catalog.nearest(code, k, [&](Course m, uint32_t) { fn(catalog.code(m.id()), m.title()); });
+        },
+        [&](std::string_view prefix, size_t k, auto&& fn) {
+            catalog.complete(prefix, k, [&](Course m) { fn(catalog.code(m.id()), m.title()); });
+        });
+}
+
+static void printSingleCourse(const Catalog& catalog, const std::string& rawInput) {
+    std::string canonical = canonCode(rawInput);
+    Course c = catalog.find(canonical);
+    if (!c) {
+        printNotFound(catalog, canonical);
+        return;
     }
-    return parts;
+
+    std::cout << catalog.code(c.id()) << ", " << c.title() << "\n";
+    if (c.prereqs().empty())
+        std::cout << "Prerequisites: None\n";
+    else {
+        std::cout << "Prerequisites: ";
+        for (size_t i = 0; i < c.prereqs().size(); ++i) {
+            std::cout << catalog.code(c.prereqs()[i]);
+            if (i + 1 < c.prereqs().size()) std::cout << ", ";
+        }
+        std::cout << "\n";
+    }
+}
+
+// Completions of a partial code (--complete), shorter codes first.
+static void printCompletions(const Catalog& catalog, const std::string& rawPrefix) {
+    std::string prefix = canonCode(rawPrefix);
+    std::cout << "Completions for " << prefix << ":\n";
+    size_t n = catalog.complete(prefix, kCompletions, [&](Course c) {
+        std::cout << catalog.code(c.id()) << ", " << c.title() << "\n";
+    });
+    if (n == 0) std::cout << "None.\n";
+}
+
+// One title search result row: "CODE, Title (score)".
+static void appendTitleHit(std::string& out, std::string_view code, std::string_view title, double score) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), " (%.2f)\n", score);
+    out.append(code).append(", ").append(title).append(buf);
+}
+
+static void printTitleSearchTotal(size_t found, size_t shown) {
+    std::cout << found << (found == 1 ? " course" : " courses");
+    if (found > shown) std::cout << ", best " << shown << " shown";
+    std::cout << ".\n";
+}
+
+// Courses whose titles contain every word of the query, best BM25 match
+// first (see TitleIndex.h).
+static void printTitleSearch(const Catalog& catalog, const std::string& text) {
+    std::string out;
+    size_t found = catalog.searchTitles(text, kTitleResults, [&](Course c, double score) {
+        appendTitleHit(out, catalog.code(c.id()), c.title(), score);
+    });
+    std::cout << "Titles matching " << trimView(text) << ":\n" << out;
+    printTitleSearchTotal(found, std::min(found, kTitleResults));
 }
 
 // -----------------------------------------------------------------------------
-// Course class (encapsulation & methods)
+// Graph + Topological Sort
 // -----------------------------------------------------------------------------
-class Course {
-private:
-    std::string number_;
-    std::string title_;
-    std::vector<std::string> prereqs_;
 
-public:
-    Course() = default;
-    Course(std::string number, std::string title)
-        : number_(canonCode(number)), title_(std::move(title)) {}
+static void printRecommendedOrder(const Catalog& catalog, TieBreak tieBreak = TieBreak::Code) {
+    if (catalog.empty()) {
+        std::cout << "No data loaded.\n";
+        return;
+    }
 
-    void addPrereq(const std::string& p) {
-        std::string norm = canonCode(p);
-        if (!norm.empty()) prereqs_.push_back(std::move(norm));
+    std::vector<CourseId> order = recommendedOrder(catalog, tieBreak);
+    std::cout << "Recommended Course Order:\n";
+    for (size_t i = 0; i < order.size(); ++i)
+        std::cout << (i + 1) << ". " << catalog.code(order[i])
+            << " - " << catalog.find(order[i]).title() << "\n";
+
+    if (order.size() != catalog.size())
+        std::cout << "\nWarning: Circular dependency detected.\n";
+}
+
+// Courses by level (LevelOrder.h): every prerequisite of a course sits in
+// an earlier level, so a student can take each level once the ones before
+// it are done. Levels list in code order.
+template <class Listed, class Line>
+static void printLevels(const LevelOrder& levels, bool complete, Listed&& listed, Line&& line) {
+    std::string out = "Courses by Level:\n";
+    for (uint32_t k = 0; k < levels.levels(); ++k) {
+        out.append("Level ").append(std::to_string(k + 1)).append(":\n");
+        for (uint32_t i = levels.levelStart()[k]; i < levels.levelStart()[k + 1]; ++i)
+            if (listed(levels.order()[i])) {
+                out.append("  ");
+                line(levels.order()[i], out);
+                out.push_back('\n');
+            }
     }
+    std::cout << out;
+    if (!complete) std::cout << "\nWarning: Circular dependency detected.\n";
+}
 
-    const std::string& number() const { return number_; }
-    const std::string& title() const { return title_; }
-    const std::vector<std::string>& prereqs() const { return prereqs_; }
-};
+static void printCourseLevels(const Catalog& catalog) {
+    if (catalog.empty()) {
+        std::cout << "No data loaded.\n";
+        return;
+    }
+    // Prerequisites outside the catalog have no edges and land in level 1,
+    // unlisted.
+    const CsrGraph& graph = catalog.graph();
+    std::vector<uint32_t> rank(catalog.idCount(), 0);
+    for (uint32_t i = 0; i < catalog.size(); ++i) rank[catalog.ordered(i).id()] = i;
+    LevelOrder levels;
+    ThreadPool& pool = ThreadPool::shared();
+    bool complete = levels.build(catalog.idCount(), [&](CourseId id) { return graph.indegree(id); },
+        [&](CourseId id) { return graph.successors(id); }, &pool);
+    levels.sortLevels([&](CourseId id) { return rank[id]; }, &pool);
+    printLevels(levels, complete, [&](CourseId id) { return catalog.hasCourse(id); },
+        [&](CourseId id, std::string& out) {
+            out.append(catalog.code(id)).append(" - ").append(catalog.find(id).title());
+        });
+}
 
-// Type alias for catalog
-using Catalog = std::unordered_map<std::string, Course>;
+// Rows of an unlocks listing, nearest first; returns how many were direct.
+template <class Line>
+static size_t printUnlockRows(const std::vector<std::pair<uint32_t, uint32_t>>& unlocks, bool transitive, Line&& line) {
+    std::string out;
+    size_t direct = 0;
+    for (const auto& u : unlocks) {
+        out.append("  ");
+        line(u.first, out);
+        if (transitive) out.append(u.second == 1 ? " (direct)" : " (" + std::to_string(u.second) + " steps)");
+        out.push_back('\n');
+        direct += u.second == 1;
+    }
+    std::cout << out;
+    return direct;
+}
 
-// -----------------------------------------------------------------------------
-// Load courses from CSV into catalog
-// -----------------------------------------------------------------------------
-static bool loadCourses(const std::string& filename, Catalog& catalog) {
-    std::ifstream fin(filename);
-    if (!fin.is_open()) return false;
+static void printUnlockTotal(size_t all, size_t direct, bool transitive) {
+    if (all == 0) std::cout << "None.\n";
+    else if (!transitive) std::cout << direct << (direct == 1 ? " course.\n" : " courses.\n");
+    else std::cout << all << (all == 1 ? " course" : " courses") << " in all, " << direct << " directly.\n";
+}
 
-    catalog.clear();
-    std::string line;
-    size_t lineNum = 0;
+// What a course unlocks: the courses that list it as a prerequisite and,
+// when transitive, the courses that need those in turn (impact analysis
+// for a cancelled course). Read from the prerequisite graph's forward edges.
+static void printUnlocks(const Catalog& catalog, const std::string& rawInput, bool transitive) {
+    std::string canonical = canonCode(rawInput);
+    Course c = catalog.find(canonical);
+    if (!c) {
+        printNotFound(catalog, canonical);
+        return;
+    }
 
-    while (std::getline(fin, line)) {
-        ++lineNum;
-        std::string check = line;
-        stripBOM(check);
-        trim(check);
-        if (check.empty() || check[0] == '#') continue;
+    const CsrGraph& graph = catalog.graph();
+    auto unlocks = collectUnlocks(c.id(), catalog.idCount(), transitive, [&](CourseId id) { return graph.successors(id); });
+    std::sort(unlocks.begin(), unlocks.end(), [&](const auto& a, const auto& b) {
+        return a.second != b.second ? a.second < b.second : catalog.idLess(a.first, b.first);
+    });
+    std::cout << "Courses unlocked by " << catalog.code(c.id()) << (transitive ? " (transitively):\n" : ":\n");
+    size_t direct = printUnlockRows(unlocks, transitive, [&](CourseId id, std::string& out) {
+        out.append(catalog.code(id)).append(", ").append(catalog.find(id).title());
+    });
+    printUnlockTotal(unlocks.size(), direct, transitive);
+}
 
-        auto fields = splitCSV(line);
-        if (fields.size() < 2) continue;
+// Splits "MATH201 CSCI400" or "MATH201, CSCI400" into its two codes; false
+// unless there are exactly two.
+static bool splitCodePair(std::string_view text, std::string& first, std::string& second) {
+    const char* seps = text.find(',') != std::string_view::npos ? "," : " \t";
+    std::vector<std::string_view> parts;
+    for (size_t at = 0; at <= text.size();) {
+        size_t end = std::min(text.find_first_of(seps, at), text.size());
+        std::string_view part = trimView(text.substr(at, end - at));
+        if (!part.empty()) parts.push_back(part);
+        at = end + 1;
+    }
+    if (parts.size() != 2) return false;
+    first.assign(parts[0]);
+    second.assign(parts[1]);
+    return true;
+}
 
-        Course c(fields[0], fields[1]);
-        for (size_t i = 2; i < fields.size(); ++i) c.addPrereq(fields[i]);
+// A shortest chain prereq -> ... -> course, found by walking back from
+// course through prerequisites; reaches(a, b) prunes the branches that do
+// not lead to prereq and must hold whenever a is required for b (exact
+// from a closure, conservative from reachability labels). predecessors(id)
+// may list ids of nodes or more, which are skipped.
+template <class Predecessors, class Reaches>
+static std::vector<uint32_t> requirementChain(uint32_t prereq, uint32_t course, size_t nodes,
+    Predecessors&& predecessors, Reaches&& reaches) {
+    std::unordered_map<uint32_t, uint32_t> next;    // id -> the course it leads to
+    std::vector<uint32_t> queue{ course };
+    for (size_t head = 0; head < queue.size(); ++head) {
+        for (uint32_t q : predecessors(queue[head])) {
+            if (q >= nodes || next.count(q) || (q != prereq && !reaches(prereq, q))) continue;
+            next[q] = queue[head];
+            if (q != prereq) {
+                queue.push_back(q);
+                continue;
+            }
+            std::vector<uint32_t> chain{ prereq };
+            do chain.push_back(next[chain.back()]);
+            while (chain.back() != course);
+            return chain;
+        }
+    }
+    return {};
+}
 
-        catalog[c.number()] = std::move(c);
+// An empty chain means prereq is not required for course.
+template <class CodeOf>
+static void printRequirementChain(const std::vector<uint32_t>& chain, std::string_view prereq, std::string_view course,
+    CodeOf&& codeOf) {
+    if (chain.empty()) {
+        std::cout << prereq << " is not required for " << course << ".\n";
+        return;
     }
+    std::cout << prereq << " is required for " << course << (chain.size() == 2 ? " directly:\n  " : ":\n  ");
+    for (size_t i = 0; i < chain.size(); ++i) std::cout << (i ? " -> " : "") << codeOf(chain[i]);
+    std::cout << "\n";
+}
 
-    return true;
+// Whether one course is a prerequisite of another, directly or through a
+// chain (one closure bit test), and the shortest such chain. Catalogs too
+// large for a closure (see Closure.h) are answered by the reachability
+// labels instead; a snapshot always carries those.
+static void printRequirement(const Catalog& catalog, const std::string& rawPrereq, const std::string& rawCourse) {
+    std::string canonPrereq = canonCode(rawPrereq), canonCourse = canonCode(rawCourse);
+    Course p = catalog.find(canonPrereq), c = catalog.find(canonCourse);
+    if (!p || !c) {
+        const std::string& missing = !p ? canonPrereq : canonCourse;
+        std::cout << missing << ": ";
+        printNotFound(catalog, missing);
+        return;
+    }
+
+    const TransitiveClosure& closure = catalog.closure();
+    const CsrGraph& graph = catalog.graph();
+    const ReachLabels* labels = closure.available() ? nullptr : &catalog.reachLabels();
+    auto mayReach = [&](CourseId a, CourseId b) { return labels ? labels->mayReach(a, b) : closure.reaches(a, b); };
+    std::vector<uint32_t> chain;
+    if (labels ? labels->reaches(p.id(), c.id()) : closure.reaches(p.id(), c.id()))
+        chain = requirementChain(p.id(), c.id(), catalog.idCount(), [&](CourseId id) { return graph.predecessors(id); }, mayReach);
+    printRequirementChain(chain, catalog.code(p.id()), catalog.code(c.id()), [&](uint32_t id) { return catalog.code(id); });
+}
+
+// One catalog edit (menu 13, --edit):
+//   add-prereq PREREQ COURSE    COURSE now requires PREREQ
+//   drop-prereq PREREQ COURSE   COURSE no longer requires PREREQ
+//   add-course COURSE TITLE     a new course, no prerequisites yet
+//   drop-course COURSE
+// The pairs read like --requires. A prerequisite that would make a course
+// require itself is rejected. The recommended order follows each edit
+// without being recomputed (see Catalog::rankedOrder).
+static void applyEdit(Catalog& catalog, std::string_view text) {
+    text = trimView(text);
+    const size_t split = std::min(text.find_first_of(" \t"), text.size());
+    const std::string_view verb = text.substr(0, split), rest = trimView(text.substr(split));
+
+    if (verb == "add-prereq" || verb == "drop-prereq") {
+        std::string rawPrereq, rawCourse;
+        if (!splitCodePair(rest, rawPrereq, rawCourse)) {
+            std::cout << verb << " needs two course numbers, e.g. \"" << verb << " MATH201 CSCI400\".\n";
+            return;
+        }
+        std::string prereq = canonCode(rawPrereq), course = canonCode(rawCourse);
+        Course c = catalog.find(course);
+        if (!c) {
+            std::cout << course << ": ";
+            printNotFound(catalog, course);
+            return;
+        }
+        if (verb == "drop-prereq") {
+            CourseId id = catalog.idOf(prereq);
+            if (id != Catalog::npos && catalog.removePrereq(c.id(), id))
+                std::cout << prereq << " is no longer a prerequisite of " << course << ".\n";
+            else std::cout << prereq << " is not a prerequisite of " << course << ".\n";
+            return;
+        }
+        if (prereq == course) {
+            std::cout << "Rejected: a course cannot require itself.\n";
+            return;
+        }
+        CourseId id = catalog.intern(prereq);
+        if (std::find(c.prereqs().begin(), c.prereqs().end(), id) != c.prereqs().end())
+            std::cout << prereq << " is already a prerequisite of " << course << ".\n";
+        else if (!catalog.addPrereq(c.id(), id))
+            std::cout << "Rejected: " << course << " is already required for " << prereq << ", so this would be circular.\n";
+        else
+            std::cout << prereq << " is now a prerequisite of " << course
+                << (catalog.hasCourse(id) ? ".\n" : " (it is not a course in the catalog).\n");
+        return;
+    }
+
+    const size_t codeEnd = std::min(rest.find_first_of(" \t,"), rest.size());
+    const std::string code = canonCode(rest.substr(0, codeEnd));
+    if (verb == "add-course") {
+        std::string_view title = trimView(rest.substr(codeEnd));
+        if (!title.empty() && title.front() == ',') title = trimView(title.substr(1));
+        if (code.empty() || title.empty()) std::cout << "add-course needs a course number and a title.\n";
+        else if (catalog.addCourse(catalog.intern(code), title)) std::cout << "Added " << code << ", " << title << ".\n";
+        else std::cout << code << " already exists.\n";
+    }
+    else if (verb == "drop-course") {
+        if (code.empty()) std::cout << "drop-course needs a course number.\n";
+        else if (catalog.removeCourse(catalog.idOf(code))) std::cout << "Removed " << code << ".\n";
+        else printNotFound(catalog, code);
+    }
+    else
+        std::cout << "Unknown edit. Use add-prereq PREREQ COURSE, drop-prereq PREREQ COURSE, add-course COURSE TITLE "
+            "or drop-course COURSE.\n";
 }
 
 // -----------------------------------------------------------------------------
-// Output helpers
+// Binary snapshot (serve queries from the mapping)
 // -----------------------------------------------------------------------------
-static void printCourseList(const Catalog& catalog) {
-    if (catalog.empty()) {
+static void printCourseList(const SnapshotView& snap, size_t pageSize = 0) {
+    if (snap.empty()) {
         std::cout << "No data loaded.\n";
         return;
     }
 
-    std::vector<std::string> keys;
-    for (const auto& kv : catalog) keys.push_back(kv.first);
-    std::sort(keys.begin(), keys.end());
-
     std::cout << "Course List:\n";
-    for (const auto& k : keys)
-        std::cout << catalog.at(k).number() << ", " << catalog.at(k).title() << "\n";
+    uint32_t id = 0;
+    streamListing(pageSize, [&](size_t n, std::string& out) {
+        for (size_t k = 0; k < n && id < snap.size(); ++k, ++id)
+            out.append(snap.code(id)).append(", ").append(snap.title(id)).push_back('\n');
+        return id < snap.size();
+    });
 }
 
-static void printSingleCourse(const Catalog& catalog, const std::string& rawInput) {
-    std::string key = canonCode(rawInput);
-    auto it = catalog.find(key);
-    if (it == catalog.end()) {
-        std::cout << "Course not found.\n";
+// Snapshot course ids are in code order, so the query runs over the ids;
+// keys are computed from the mapped codes as the search touches them.
+static void printCodeQuery(const SnapshotView& snap, const std::string& text, size_t pageSize = 0) {
+    CodeQuery query;
+    std::string error;
+    if (!query.parse(text, error)) {
+        std::cout << "Invalid query: " << error << ".\n";
         return;
     }
 
-    const Course& c = it->second;
-    std::cout << c.number() << ", " << c.title() << "\n";
-    if (c.prereqs().empty())
+    auto range = query.candidates(snap.size(), [&](size_t id) { return codeSortKey(snap.code((uint32_t)id)); });
+    uint32_t id = (uint32_t)range.first;
+    size_t found = 0;
+    std::cout << "Courses matching " << trimView(text) << ":\n";
+    streamListing(pageSize, [&](size_t n, std::string& out) {
+        for (size_t k = 0; k < n && id < range.second; ++id) {
+            if (!query.matches(snap.code(id))) continue;
+            out.append(snap.code(id)).append(", ").append(snap.title(id)).push_back('\n');
+            ++k;
+            ++found;
+        }
+        return id < range.second;
+    });
+    std::cout << found << (found == 1 ? " course.\n" : " courses.\n");
+}
+
+static void printNotFound(const SnapshotView& snap, const std::string& canonical) {
+    std::cout << "Course not found.\n";
+    printSuggestions(canonical,
+        [&](std::string_view code, size_t k, auto&& fn) {
+            snap.nearest(code, k, [&](uint32_t m, uint32_t) { fn(snap.code(m), snap.title(m)); });
+        },
+        [&](std::string_view prefix, size_t k, auto&& fn) {
+            snap.complete(prefix, k, [&](uint32_t m) { fn(snap.code(m), snap.title(m)); });
+        });
+}
+
+static void printSingleCourse(const SnapshotView& snap, const std::string& rawInput) {
+    std::string canonical = canonCode(rawInput);
+    uint32_t id = snap.empty() ? SnapshotView::npos : snap.find(canonical);
+    if (id == SnapshotView::npos) {
+        printNotFound(snap, canonical);
+        return;
+    }
+
+    std::cout << snap.code(id) << ", " << snap.title(id) << "\n";
+    IdSpan pre = snap.prereqs(id);
+    if (pre.empty())
         std::cout << "Prerequisites: None\n";
     else {
         std::cout << "Prerequisites: ";
-        for (size_t i = 0; i < c.prereqs().size(); ++i) {
-            std::cout << c.prereqs()[i];
-            if (i + 1 < c.prereqs().size()) std::cout << ", ";
+        for (size_t i = 0; i < pre.size(); ++i) {
+            std::cout << snap.code(pre[i]);
+            if (i + 1 < pre.size()) std::cout << ", ";
         }
         std::cout << "\n";
     }
 }
 
-// -----------------------------------------------------------------------------
-// Graph + Topological Sort
-// -----------------------------------------------------------------------------
-static void buildGraph(const Catalog& catalog,
-    std::unordered_map<std::string, std::vector<std::string>>& adj,
-    std::unordered_map<std::string, int>& indegree)
-{
-    adj.clear(); indegree.clear();
-
-    for (const auto& kv : catalog) {
-        adj[kv.first]; indegree[kv.first] = 0;
-    }
+static void printCompletions(const SnapshotView& snap, const std::string& rawPrefix) {
+    std::string prefix = canonCode(rawPrefix);
+    std::cout << "Completions for " << prefix << ":\n";
+    size_t n = snap.complete(prefix, kCompletions, [&](uint32_t id) {
+        std::cout << snap.code(id) << ", " << snap.title(id) << "\n";
+    });
+    if (n == 0) std::cout << "None.\n";
+}
 
-    for (const auto& kv : catalog) {
-        for (const auto& p : kv.second.prereqs()) {
-            if (catalog.find(p) != catalog.end()) {
-                adj[p].push_back(kv.first);
-                ++indegree[kv.first];
-            }
-        }
-    }
+// Snapshot ids are in code order, so equal scores rank by id.
+static void printTitleSearch(const SnapshotView& snap, const std::string& text) {
+    std::vector<TitleIndexView::Hit> hits;
+    size_t found = snap.searchTitles(text, kTitleResults, hits);
+    std::string out;
+    for (const TitleIndexView::Hit& h : hits) appendTitleHit(out, snap.code(h.doc), snap.title(h.doc), h.score);
+    std::cout << "Titles matching " << trimView(text) << ":\n" << out;
+    printTitleSearchTotal(found, hits.size());
 }
 
-static void printRecommendedOrder(const Catalog& catalog) {
-    if (catalog.empty()) {
-        std::cout << "No data loaded.\n";
+// Snapshot successors are the catalog graph's, and ids are in code order.
+static void printUnlocks(const SnapshotView& snap, const std::string& rawInput, bool transitive) {
+    std::string canonical = canonCode(rawInput);
+    uint32_t id = snap.empty() ? SnapshotView::npos : snap.find(canonical);
+    if (id == SnapshotView::npos) {
+        printNotFound(snap, canonical);
         return;
     }
 
-    std::unordered_map<std::string, std::vector<std::string>> adj;
-    std::unordered_map<std::string, int> indegree;
-    buildGraph(catalog, adj, indegree);
+    auto unlocks = collectUnlocks(id, snap.size(), transitive, [&](uint32_t u) { return snap.successors(u); });
+    std::sort(unlocks.begin(), unlocks.end(), [](const auto& a, const auto& b) {
+        return a.second != b.second ? a.second < b.second : a.first < b.first;
+    });
+    std::cout << "Courses unlocked by " << snap.code(id) << (transitive ? " (transitively):\n" : ":\n");
+    size_t direct = printUnlockRows(unlocks, transitive, [&](uint32_t u, std::string& out) {
+        out.append(snap.code(u)).append(", ").append(snap.title(u));
+    });
+    printUnlockTotal(unlocks.size(), direct, transitive);
+}
 
-    std::set<std::string> zero;
-    for (auto& kv : indegree)
-        if (kv.second == 0) zero.insert(kv.first);
+static void printRequirement(const SnapshotView& snap, const std::string& rawPrereq, const std::string& rawCourse) {
+    std::string canonPrereq = canonCode(rawPrereq), canonCourse = canonCode(rawCourse);
+    uint32_t p = snap.empty() ? SnapshotView::npos : snap.find(canonPrereq);
+    uint32_t c = snap.empty() ? SnapshotView::npos : snap.find(canonCourse);
+    if (p == SnapshotView::npos || c == SnapshotView::npos) {
+        const std::string& missing = p == SnapshotView::npos ? canonPrereq : canonCourse;
+        std::cout << missing << ": ";
+        printNotFound(snap, missing);
+        return;
+    }
 
-    std::vector<std::string> order;
-    while (!zero.empty()) {
-        auto it = zero.begin();
-        std::string u = *it;
-        zero.erase(it);
-        order.push_back(u);
+    auto mayReach = [&](uint32_t a, uint32_t b) { return snap.mayReach(a, b); };
+    std::vector<uint32_t> chain;
+    if (snap.reaches(p, c)) chain = requirementChain(p, c, snap.size(), [&](uint32_t id) { return snap.prereqs(id); }, mayReach);
+    printRequirementChain(chain, snap.code(p), snap.code(c), [&](uint32_t id) { return snap.code(id); });
+}
 
-        for (auto& v : adj[u])
-            if (--indegree[v] == 0) zero.insert(v);
+// Course ids are in sorted code order, so they rank themselves.
+static void printRecommendedOrder(const SnapshotView& snap, TieBreak tieBreak = TieBreak::Code) {
+    if (snap.empty()) {
+        std::cout << "No data loaded.\n";
+        return;
     }
 
+    std::vector<uint32_t> indegree(snap.size()), order;
+    for (uint32_t id = 0; id < snap.size(); ++id) indegree[id] = snap.indegree(id);
+    order.reserve(snap.size());
+    kahnOrder(order, snap.size(), tieBreak, [](uint32_t) { return true; }, std::move(indegree),
+        [&](uint32_t id) { return snap.successors(id); }, [](uint32_t id) { return id; });
+
     std::cout << "Recommended Course Order:\n";
     for (size_t i = 0; i < order.size(); ++i)
-        std::cout << (i + 1) << ". " << catalog.at(order[i]).number()
-            << " - " << catalog.at(order[i]).title() << "\n";
+        std::cout << (i + 1) << ". " << snap.code(order[i]) << " - " << snap.title(order[i]) << "\n";
 
-    if (order.size() != catalog.size())
+    if (order.size() != snap.size())
         std::cout << "\nWarning: Circular dependency detected.\n";
 }
 
+static void printCourseLevels(const SnapshotView& snap) {
+    if (snap.empty()) {
+        std::cout << "No data loaded.\n";
+        return;
+    }
+    LevelOrder levels;
+    ThreadPool& pool = ThreadPool::shared();
+    bool complete = levels.build(snap.size(), [&](uint32_t id) { return snap.indegree(id); },
+        [&](uint32_t id) { return snap.successors(id); }, &pool);
+    levels.sortLevels([](uint32_t id) { return id; }, &pool);
+    printLevels(levels, complete, [](uint32_t) { return true; },
+        [&](uint32_t id, std::string& out) { out.append(snap.code(id)).append(" - ").append(snap.title(id)); });
+}
+
 // -----------------------------------------------------------------------------
 // Database connection demo (SQLite integration)
 // -----------------------------------------------------------------------------
@@ -251,14 +661,156 @@ static void printMenu() {
         << "3. Print Course Details\n"
         << "4. Print Recommended Course Order\n"
         << "5. Test Database Connection (SQLite)\n"
+        << "6. Save Catalog Snapshot\n"
+        << "7. Load Catalog Snapshot\n"
+        << "8. Find Courses by Range (e.g. MATH3XX, CSCI300-CSCI499, CS*)\n"
+        << "10. Search Course Titles (e.g. operating systems)\n"
+        << "11. Show Courses Unlocked by a Course\n"
+        << "12. Check Whether a Course Is Required for Another\n"
+        << "13. Edit Courses and Prerequisites\n"
+        << "14. Print Courses by Level\n"
         << "9. Exit\n";
 }
 
-int main() {
+// Loads a CSV catalog and reports how many courses it holds and how long
+// the load took, as openSnapshot does for snapshots.
+static bool openCsv(const std::string& filename, Catalog& catalog, const LoadOptions& opts) {
+    auto start = std::chrono::steady_clock::now();
+    if (!loadCourses(filename, catalog, opts)) {
+        std::cout << "Failed to open file.\n";
+        return false;
+    }
+    std::chrono::duration<double, std::milli> ms = std::chrono::steady_clock::now() - start;
+    std::cout << "Loaded " << catalog.size() << " courses in " << ms.count() << " ms.\n";
+    return true;
+}
+
+static bool openSnapshot(const std::string& filename, SnapshotView& snapshot, Catalog& catalog) {
+    auto start = std::chrono::steady_clock::now();
+    std::string error;
+    if (!snapshot.open(filename, error)) {
+        std::cout << "Failed to load snapshot: " << error << ".\n";
+        return false;
+    }
+    catalog.clear();
+    std::chrono::duration<double, std::milli> ms = std::chrono::steady_clock::now() - start;
+    std::cout << "Loaded " << snapshot.size() << " courses from snapshot in " << ms.count() << " ms.\n";
+    return true;
+}
+
+// One --query, --complete, --search, --unlocks[-all] or --requires argument
+// of batch mode.
+struct BatchRequest {
+    enum Kind { Query, Complete, Search, Unlocks, UnlocksAll, Requires, Edit, Order, Levels } kind;
+    std::string text;
+};
+
+// Batch mode: answers each request against the --snapshot or --csv
+// catalog and exits. A text of "-" reads one request per line from stdin.
+static bool runBatch(const std::vector<BatchRequest>& requests, const std::string& csv,
+    const std::string& snapshotFile, const LoadOptions& opts) {
     Catalog catalog;
+    SnapshotView snapshot;
+    std::string error;
+    if (!snapshotFile.empty()) {
+        if (!snapshot.open(snapshotFile, error)) {
+            std::cout << "Failed to load snapshot: " << error << ".\n";
+            return false;
+        }
+    }
+    else if (csv.empty() || !loadCourses(csv, catalog, opts)) {
+        std::cout << (csv.empty() ? "Batch requests need --csv FILE or --snapshot FILE.\n"
+            : "Failed to open file.\n");
+        return false;
+    }
+
+    auto answer = [&](BatchRequest::Kind kind, const std::string& text) {
+        bool snap = snapshot.isOpen();
+        switch (kind) {
+        case BatchRequest::Query: snap ? printCodeQuery(snapshot, text) : printCodeQuery(catalog, text); break;
+        case BatchRequest::Complete: snap ? printCompletions(snapshot, text) : printCompletions(catalog, text); break;
+        case BatchRequest::Search: snap ? printTitleSearch(snapshot, text) : printTitleSearch(catalog, text); break;
+        case BatchRequest::Unlocks:
+        case BatchRequest::UnlocksAll: {
+            bool transitive = kind == BatchRequest::UnlocksAll;
+            snap ? printUnlocks(snapshot, text, transitive) : printUnlocks(catalog, text, transitive);
+            break;
+        }
+        case BatchRequest::Requires: {
+            std::string prereq, course;
+            if (!splitCodePair(text, prereq, course)) std::cout << "--requires needs two course numbers, e.g. \"MATH201 CSCI400\".\n";
+            else snap ? printRequirement(snapshot, prereq, course) : printRequirement(catalog, prereq, course);
+            break;
+        }
+        case BatchRequest::Edit:
+            if (snap) std::cout << "Snapshots are read-only; edit with --csv FILE.\n";
+            else applyEdit(catalog, text);
+            break;
+        case BatchRequest::Order: {
+            TieBreak tieBreak;
+            if (!parseTieBreak(text, tieBreak)) std::cout << "Unknown order '" << text << "'. Use code, level or unlocks.\n";
+            else snap ? printRecommendedOrder(snapshot, tieBreak) : printRecommendedOrder(catalog, tieBreak);
+            break;
+        }
+        case BatchRequest::Levels: snap ? printCourseLevels(snapshot) : printCourseLevels(catalog); break;
+        }
+    };
+    for (const BatchRequest& r : requests) {
+        if (r.text != "-") {
+            answer(r.kind, r.text);
+            continue;
+        }
+        std::string line;
+        while (std::getline(std::cin, line))
+            if (!trimView(line).empty()) answer(r.kind, line);
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    Catalog catalog;
+    SnapshotView snapshot;      // when open, queries are served from it
+    LoadOptions loadOpts;
     bool running = true;
+    std::string startupSnapshot, startupCsv;
+    std::vector<BatchRequest> batch;    // --query, --unlocks, ...; "-" reads stdin
+    size_t pageSize = 0;        // course list rows per page; 0 = no paging
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        size_t count = 0;
+        if (arg == "--threads" && i + 1 < argc && parseCount(argv[++i], 1024, count)) loadOpts.threads = (unsigned)count;
+        else if (arg == "--bench" && i + 1 < argc) return runBenchmark(argv[++i]) ? 0 : 1;
+        else if (arg == "--test" && i + 1 < argc) return runTests(argv[++i]) ? 0 : 1;
+        else if (arg == "--snapshot" && i + 1 < argc) startupSnapshot = argv[++i];
+        else if (arg == "--freeze") loadOpts.freeze = true;
+        else if (arg == "--page" && i + 1 < argc && parseCount(argv[++i], SIZE_MAX, count)) pageSize = count;
+        else if (arg == "--csv" && i + 1 < argc) startupCsv = argv[++i];
+        else if (arg == "--query" && i + 1 < argc) batch.push_back({ BatchRequest::Query, argv[++i] });
+        else if (arg == "--complete" && i + 1 < argc) batch.push_back({ BatchRequest::Complete, argv[++i] });
+        else if (arg == "--search" && i + 1 < argc) batch.push_back({ BatchRequest::Search, argv[++i] });
+        else if (arg == "--unlocks" && i + 1 < argc) batch.push_back({ BatchRequest::Unlocks, argv[++i] });
+        else if (arg == "--unlocks-all" && i + 1 < argc) batch.push_back({ BatchRequest::UnlocksAll, argv[++i] });
+        else if (arg == "--requires" && i + 1 < argc) batch.push_back({ BatchRequest::Requires, argv[++i] });
+        else if (arg == "--edit" && i + 1 < argc) batch.push_back({ BatchRequest::Edit, argv[++i] });
+        else if (arg == "--order") batch.push_back({ BatchRequest::Order, "" });
+        else if (arg == "--order-by" && i + 1 < argc) batch.push_back({ BatchRequest::Order, argv[++i] });
+        else if (arg == "--levels") batch.push_back({ BatchRequest::Levels, "" });
+        else {
+            std::cout << "Usage: ProjectTwo [--threads N] [--freeze] [--page N] [--snapshot FILE] [--csv FILE]\n"
+                << "                  [--query Q]... [--complete PREFIX]... [--search WORDS]...\n"
+                << "                  [--unlocks CODE]... [--unlocks-all CODE]... [--requires \"PREREQ COURSE\"]...\n"
+                << "                  [--edit EDIT]... [--order] [--order-by code|level|unlocks] [--levels]\n"
+                << "                  [--bench NAME] [--test NAME|all]\n";
+            return 1;
+        }
+    }
+
+    if (!batch.empty()) return runBatch(batch, startupCsv, startupSnapshot, loadOpts) ? 0 : 1;
 
     std::cout << "Welcome to the Course Planner!\n";
+    if (!startupSnapshot.empty()) openSnapshot(startupSnapshot, snapshot, catalog);
+    else if (!startupCsv.empty()) openCsv(startupCsv, catalog, loadOpts);
 
     while (running) {
         printMenu();
@@ -271,19 +823,90 @@ int main() {
             std::cout << "Enter file name (e.g., courses.csv): ";
             std::string filename; std::getline(std::cin, filename);
             trim(filename);
-            if (loadCourses(filename, catalog))
-                std::cout << "Loaded " << catalog.size() << " courses.\n";
-            else
-                std::cout << "Failed to open file.\n";
+            if (openCsv(filename, catalog, loadOpts)) snapshot.close();
+        }
+        else if (choice == "2") {
+            if (snapshot.isOpen()) printCourseList(snapshot, pageSize);
+            else printCourseList(catalog, pageSize);
         }
-        else if (choice == "2") printCourseList(catalog);
         else if (choice == "3") {
             std::cout << "Enter course number: ";
             std::string num; std::getline(std::cin, num);
-            printSingleCourse(catalog, num);
+            if (snapshot.isOpen()) printSingleCourse(snapshot, num);
+            else printSingleCourse(catalog, num);
+        }
+        else if (choice == "4") {
+            std::cout << "Order ties by (code, level or unlocks; Enter for code): ";
+            std::string text; std::getline(std::cin, text);
+            TieBreak tieBreak;
+            if (!parseTieBreak(trimView(text), tieBreak)) std::cout << "Unknown order '" << text << "'. Use code, level or unlocks.\n";
+            else if (snapshot.isOpen()) printRecommendedOrder(snapshot, tieBreak);
+            else printRecommendedOrder(catalog, tieBreak);
         }
-        else if (choice == "4") printRecommendedOrder(catalog);
         else if (choice == "5") testDatabaseConnection();
+        else if (choice == "6") {
+            if (catalog.empty()) {
+                std::cout << "Load a CSV file first.\n";
+                continue;
+            }
+            std::cout << "Enter snapshot file name (e.g., courses.snap): ";
+            std::string filename; std::getline(std::cin, filename);
+            trim(filename);
+            if (writeSnapshot(filename, buildSnapshotData(catalog)))
+                std::cout << "Saved " << catalog.size() << " courses to " << filename << ".\n";
+            else
+                std::cout << "Failed to write snapshot.\n";
+        }
+        else if (choice == "7") {
+            std::cout << "Enter snapshot file name (e.g., courses.snap): ";
+            std::string filename; std::getline(std::cin, filename);
+            trim(filename);
+            openSnapshot(filename, snapshot, catalog);
+        }
+        else if (choice == "8") {
+            std::cout << "Enter query: ";
+            std::string text; std::getline(std::cin, text);
+            if (snapshot.isOpen()) printCodeQuery(snapshot, text, pageSize);
+            else printCodeQuery(catalog, text, pageSize);
+        }
+        else if (choice == "10") {
+            std::cout << "Enter words to search for: ";
+            std::string text; std::getline(std::cin, text);
+            if (snapshot.isOpen()) printTitleSearch(snapshot, text);
+            else printTitleSearch(catalog, text);
+        }
+        else if (choice == "11") {
+            std::cout << "Enter course number: ";
+            std::string num; std::getline(std::cin, num);
+            std::cout << "Include transitive unlocks? (y/N): ";
+            std::string answer; std::getline(std::cin, answer);
+            trim(answer);
+            bool transitive = answer == "y" || answer == "Y";
+            if (snapshot.isOpen()) printUnlocks(snapshot, num, transitive);
+            else printUnlocks(catalog, num, transitive);
+        }
+        else if (choice == "12") {
+            std::cout << "Enter prerequisite course number: ";
+            std::string prereq; std::getline(std::cin, prereq);
+            std::cout << "Enter course number: ";
+            std::string course; std::getline(std::cin, course);
+            if (snapshot.isOpen()) printRequirement(snapshot, prereq, course);
+            else printRequirement(catalog, prereq, course);
+        }
+        else if (choice == "13") {
+            if (snapshot.isOpen() || catalog.empty()) {
+                std::cout << "Load a CSV file first; snapshots are read-only.\n";
+                continue;
+            }
+            std::cout << "Enter edit (add-prereq PREREQ COURSE, drop-prereq PREREQ COURSE,\n"
+                << "            add-course COURSE TITLE, drop-course COURSE): ";
+            std::string text; std::getline(std::cin, text);
+            applyEdit(catalog, text);
+        }
+        else if (choice == "14") {
+            if (snapshot.isOpen()) printCourseLevels(snapshot);
+            else printCourseLevels(catalog);
+        }
         else if (choice == "9") {
             std::cout << "Exiting program. Goodbye!\n";
             running = false;
@@ -0,0 +1,252 @@
+﻿// RadixSort.h
+// CS499 – Final ePortfolio Artifact (Advising Assistance Program)
+//
+// Description:
+// Most-significant-digit radix sort of items by a string key, for ordering
+// course codes. Canonical codes are short upper-case alphanumerics that
+// often share a department prefix, which suits MSD radix sort much better
+// than comparison sorting: each byte of a key is looked at about once.
+//
+// radixSortByKey() first skips the prefix shared by every key, then
+// partitions on the next two bytes at once (257 * 257 buckets, counted
+// and scattered in parallel chunks on a ThreadPool). The buckets are then
+// finished independently, in parallel, by a sequential byte-at-a-time MSD
+// sort that switches to insertion sort for small ranges. The byte value
+// 0 is reserved for "key ended", so shorter keys sort before longer ones
+// that extend them, exactly as std::string_view's operator< orders them.
+//
+// radixSortByU64() sorts by an integer key instead (the packed natural
+// sort keys of CourseCode.h): a stable least-significant-digit sort with
+// 11-bit digits that skips every digit on which all keys agree.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#include "ThreadPool.h"
+
+namespace radix {
+
+struct Entry {
+    const unsigned char* key;
+    uint32_t len;
+    uint32_t item;
+};
+
+// Bucket of e at byte `depth`: 0 when the key has ended, else byte + 1.
+static inline unsigned digit(const Entry& e, size_t depth) {
+    return depth < e.len ? e.key[depth] + 1u : 0u;
+}
+
+// Orders keys that are already known to be equal before `depth`.
+static inline bool lessFrom(const Entry& a, const Entry& b, size_t depth) {
+    size_t la = a.len - depth, lb = b.len - depth;
+    int c = std::memcmp(a.key + depth, b.key + depth, std::min(la, lb));
+    return c < 0 || (c == 0 && la < lb);
+}
+
+static inline void insertionSort(Entry* a, size_t n, size_t depth) {
+    for (size_t i = 1; i < n; ++i) {
+        Entry v = a[i];
+        size_t j = i;
+        for (; j > 0 && lessFrom(v, a[j - 1], depth); --j) a[j] = a[j - 1];
+        a[j] = v;
+    }
+}
+
+static const size_t kInsertionMax = 24;
+
+// Sequential MSD sort of a[0, n), all keys equal before `depth`. scratch
+// must have room for n entries.
+static void msd(Entry* a, Entry* scratch, size_t n, size_t depth) {
+    while (n > kInsertionMax) {
+        size_t count[257] = {};
+        for (size_t i = 0; i < n; ++i) ++count[digit(a[i], depth)];
+
+        // Every key has the same byte here: go one deeper without moving.
+        unsigned only = digit(a[0], depth);
+        if (count[only] == n) {
+            if (only == 0) return;
+            ++depth;
+            continue;
+        }
+
+        size_t start[257];
+        size_t sum = 0;
+        for (unsigned b = 0; b < 257; ++b) {
+            start[b] = sum;
+            sum += count[b];
+        }
+        size_t pos[257];
+        std::memcpy(pos, start, sizeof(pos));
+        for (size_t i = 0; i < n; ++i) scratch[pos[digit(a[i], depth)]++] = a[i];
+        std::memcpy(a, scratch, n * sizeof(Entry));
+
+        // Bucket 0 holds keys that ended: they are all equal.
+        for (unsigned b = 1; b < 257; ++b)
+            if (count[b] > 1) msd(a + start[b], scratch + start[b], count[b], depth + 1);
+        return;
+    }
+    insertionSort(a, n, depth);
+}
+
+// Runs fn(chunk, begin, end) over `chunks` equal slices of [0, n), on the
+// pool when there is one.
+template <class Fn>
+static void forChunks(ThreadPool* pool, size_t n, size_t chunks, Fn&& fn) {
+    const size_t chunkLen = (n + chunks - 1) / chunks;
+    auto run = [&](size_t c) {
+        size_t b = c * chunkLen, e = std::min(n, b + chunkLen);
+        if (b < e) fn(c, b, e);
+    };
+    if (pool && chunks > 1) pool->parallelFor(chunks, run);
+    else for (size_t c = 0; c < chunks; ++c) run(c);
+}
+
+// Several chunks per thread so uneven chunks still balance.
+static inline size_t chunkCount(ThreadPool* pool) {
+    return pool && pool->size() > 1 ? (size_t)pool->size() * 4 : 1;
+}
+
+} // namespace radix
+
+// Sorts items by keyOf(item) (a std::string_view). The views must stay
+// valid for the duration of the call. Ties keep no particular order.
+template <class KeyOf>
+static void radixSortByKey(std::vector<uint32_t>& items, KeyOf&& keyOf, ThreadPool* pool = nullptr) {
+    using radix::Entry;
+    const size_t n = items.size();
+    if (n < 2) return;
+
+    const size_t chunks = radix::chunkCount(pool);
+    auto forChunks = [&](auto&& fn) { radix::forChunks(pool, n, chunks, fn); };
+
+    std::vector<Entry> a(n), scratch(n);
+    forChunks([&](size_t, size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i) {
+            std::string_view k = keyOf(items[i]);
+            a[i] = Entry{ (const unsigned char*)k.data(), (uint32_t)k.size(), items[i] };
+        }
+    });
+
+    // Prefix shared by every key.
+    std::vector<size_t> chunkLcp(chunks, a[0].len);
+    forChunks([&](size_t c, size_t b, size_t e) {
+        size_t lcp = a[0].len;
+        for (size_t i = b; i < e && lcp; ++i) {
+            size_t m = std::min<size_t>(lcp, a[i].len), k = 0;
+            while (k < m && a[i].key[k] == a[0].key[k]) ++k;
+            lcp = k;
+        }
+        chunkLcp[c] = lcp;
+    });
+    const size_t depth = *std::min_element(chunkLcp.begin(), chunkLcp.end());
+
+    // Two-byte partition after the shared prefix, counted per chunk.
+    const size_t kBuckets = 257 * 257;
+    auto digit2 = [&](const Entry& x) { return radix::digit(x, depth) * 257 + radix::digit(x, depth + 1); };
+    std::vector<uint32_t> counts(chunks * kBuckets, 0);
+    forChunks([&](size_t c, size_t b, size_t e) {
+        uint32_t* cnt = &counts[c * kBuckets];
+        for (size_t i = b; i < e; ++i) ++cnt[digit2(a[i])];
+    });
+
+    // Bucket-major, chunk-minor offsets keep the scatter stable per chunk.
+    std::vector<size_t> bucketStart(kBuckets + 1, 0);
+    {
+        size_t sum = 0;
+        for (size_t bk = 0; bk < kBuckets; ++bk) {
+            bucketStart[bk] = sum;
+            for (size_t c = 0; c < chunks; ++c) {
+                uint32_t k = counts[c * kBuckets + bk];
+                counts[c * kBuckets + bk] = (uint32_t)sum;
+                sum += k;
+            }
+        }
+        bucketStart[kBuckets] = sum;
+    }
+    forChunks([&](size_t c, size_t b, size_t e) {
+        uint32_t* pos = &counts[c * kBuckets];
+        for (size_t i = b; i < e; ++i) scratch[pos[digit2(a[i])]++] = a[i];
+    });
+
+    // Finish each bucket whose keys continue past both partition bytes;
+    // a bucket with an ended key (digit 0) holds equal keys only.
+    std::vector<uint32_t> open;
+    for (size_t bk = 0; bk < kBuckets; ++bk)
+        if (bucketStart[bk + 1] - bucketStart[bk] > 1 && bk / 257 != 0 && bk % 257 != 0) open.push_back((uint32_t)bk);
+    auto finish = [&](size_t i) {
+        size_t bk = open[i], b = bucketStart[bk], len = bucketStart[bk + 1] - b;
+        radix::msd(scratch.data() + b, a.data() + b, len, depth + 2);
+    };
+    if (chunks > 1) pool->parallelFor(open.size(), finish);
+    else for (size_t i = 0; i < open.size(); ++i) finish(i);
+
+    forChunks([&](size_t, size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i) items[i] = scratch[i].item;
+    });
+}
+
+// Sorts items by keyOf(item) (a uint64_t). Stable.
+template <class KeyOf>
+static void radixSortByU64(std::vector<uint32_t>& items, KeyOf&& keyOf, ThreadPool* pool = nullptr) {
+    struct Pair {
+        uint64_t key;
+        uint32_t item;
+    };
+    const size_t n = items.size();
+    if (n < 2) return;
+
+    const size_t chunks = radix::chunkCount(pool);
+    auto forChunks = [&](auto&& fn) { radix::forChunks(pool, n, chunks, fn); };
+
+    // Bits that differ between keys; digits outside them need no pass.
+    std::vector<Pair> a(n), b(n);
+    std::vector<uint64_t> ors(chunks, 0), ands(chunks, ~0ull);
+    forChunks([&](size_t c, size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            a[i] = Pair{ keyOf(items[i]), items[i] };
+            ors[c] |= a[i].key;
+            ands[c] &= a[i].key;
+        }
+    });
+    uint64_t varying = 0, all = ~0ull;
+    for (size_t c = 0; c < chunks; ++c) {
+        varying |= ors[c];
+        all &= ands[c];
+    }
+    varying &= ~all;
+
+    const unsigned kBits = 11;
+    const size_t kDigits = size_t(1) << kBits;
+    std::vector<uint32_t> counts(chunks * kDigits);
+    for (unsigned shift = 0; shift < 64; shift += kBits) {
+        if (((varying >> shift) & (kDigits - 1)) == 0) continue;
+        std::fill(counts.begin(), counts.end(), 0);
+        forChunks([&](size_t c, size_t lo, size_t hi) {
+            uint32_t* cnt = &counts[c * kDigits];
+            for (size_t i = lo; i < hi; ++i) ++cnt[(a[i].key >> shift) & (kDigits - 1)];
+        });
+        uint32_t sum = 0;
+        for (size_t d = 0; d < kDigits; ++d)
+            for (size_t c = 0; c < chunks; ++c) {
+                uint32_t k = counts[c * kDigits + d];
+                counts[c * kDigits + d] = sum;
+                sum += k;
+            }
+        forChunks([&](size_t c, size_t lo, size_t hi) {
+            uint32_t* pos = &counts[c * kDigits];
+            for (size_t i = lo; i < hi; ++i) b[pos[(a[i].key >> shift) & (kDigits - 1)]++] = a[i];
+        });
+        a.swap(b);
+    }
+
+    forChunks([&](size_t, size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) items[i] = a[i].item;
+    });
+}
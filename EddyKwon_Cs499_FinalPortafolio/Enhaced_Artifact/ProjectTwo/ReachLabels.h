@@ -0,0 +1,237 @@
+﻿// ReachLabels.h
+// CS499 – Final ePortfolio Artifact (Advising Assistance Program)
+//
+// Description:
+// Reachability ("is MATH201 required for CSCI400?") in linear memory, for
+// catalogs whose transitive closure (Closure.h) no longer fits. Works on
+// the condensed prerequisite DAG (Condensation.h) and keeps a few
+// integers per component:
+//
+//   position   topological: a can only reach v from a smaller position;
+//   level      longest prerequisite chain ending at the component: a
+//              can only reach v from a lower level;
+//   intervals  two depth-first traversals over the successors (children
+//              in opposite orders) number components in post-order and
+//              give each the range [lowest post-order it reaches, its
+//              own]. If a reaches v, v's range sits inside a's in both,
+//              so a range that sticks out proves a cannot reach v;
+//   tree low   the lowest post-order in a's subtree of the first
+//              traversal's spanning tree: v's number falling in
+//              [tree low, post] proves a reaches v.
+//
+// Most queries are settled by those tests alone. The rest search back
+// from v through the prerequisite rows, skipping every component that
+// the tests show a cannot reach. Prerequisite chains are short and narrow
+// next to what a course unlocks, so the search stays small.
+//
+// ReachView evaluates over borrowed arrays (a ReachLabels' own vectors or
+// sections of a mapped snapshot), like PerfectHashView. Searches use a
+// caller-provided ReachScratch, so threads can share one view.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "Condensation.h"
+
+// Per-component label fields, in this order.
+enum ReachField : uint32_t {
+    kReachLevel,        // bit 31 set when the component is a cycle
+    kReachTreeLow,
+    kReachLow0,
+    kReachPost0,
+    kReachLow1,
+    kReachPost1,
+    kReachFields
+};
+
+static const uint32_t kReachCyclic = 0x80000000u;
+
+struct ReachScratch {
+    std::vector<uint32_t> stamp;    // components; == round when visited
+    std::vector<uint32_t> stack;
+    uint32_t round = 0;
+};
+
+struct ReachView {
+    const uint32_t* component = nullptr;    // nodes: node -> position
+    const uint32_t* predStart = nullptr;    // components + 1
+    const uint32_t* pred = nullptr;         // descending positions
+    const uint32_t* labels = nullptr;       // components * kReachFields
+    uint32_t nodes = 0;
+    uint32_t components = 0;
+
+    bool empty() const { return components == 0; }
+
+    // Whether component a may reach component b (false proves it cannot).
+    bool mayReach(uint32_t a, uint32_t b) const {
+        const uint32_t* la = labels + (size_t)a * kReachFields;
+        const uint32_t* lb = labels + (size_t)b * kReachFields;
+        return a < b && (la[kReachLevel] & ~kReachCyclic) < (lb[kReachLevel] & ~kReachCyclic) &&
+            la[kReachLow0] <= lb[kReachLow0] && lb[kReachPost0] <= la[kReachPost0] &&
+            la[kReachLow1] <= lb[kReachLow1] && lb[kReachPost1] <= la[kReachPost1];
+    }
+
+    // Whether b lies in a's spanning subtree (true proves a reaches b).
+    bool treeReach(uint32_t a, uint32_t b) const {
+        const uint32_t* la = labels + (size_t)a * kReachFields;
+        const uint32_t post = labels[(size_t)b * kReachFields + kReachPost0];
+        return la[kReachTreeLow] <= post && post <= la[kReachPost0];
+    }
+
+    // The labels alone, for pruning searches: false proves node a is not
+    // required by node v.
+    bool mayReachNode(uint32_t a, uint32_t v) const {
+        const uint32_t ca = component[a], cv = component[v];
+        return ca == cv ? (labels[(size_t)ca * kReachFields + kReachLevel] & kReachCyclic) != 0 : mayReach(ca, cv);
+    }
+
+    // True if node a is required, directly or indirectly, by node v (on a
+    // cycle, a node requires itself).
+    bool reaches(uint32_t a, uint32_t v, ReachScratch& scratch) const {
+        const uint32_t ca = component[a], cv = component[v];
+        if (ca == cv) return (labels[(size_t)ca * kReachFields + kReachLevel] & kReachCyclic) != 0;
+        if (!mayReach(ca, cv)) return false;
+        if (treeReach(ca, cv)) return true;
+
+        if (scratch.stamp.size() != components) {
+            scratch.stamp.assign(components, 0);
+            scratch.round = 0;
+        }
+        if (++scratch.round == 0) {
+            std::fill(scratch.stamp.begin(), scratch.stamp.end(), 0);
+            scratch.round = 1;
+        }
+        scratch.stack.assign(1, cv);
+        while (!scratch.stack.empty()) {
+            const uint32_t x = scratch.stack.back();
+            scratch.stack.pop_back();
+            // Rows are descending and nothing before ca is reached from it.
+            for (const uint32_t* p = pred + predStart[x], *e = pred + predStart[x + 1]; p < e && *p >= ca; ++p) {
+                if (treeReach(ca, *p)) return true;
+                if (scratch.stamp[*p] == scratch.round) continue;
+                scratch.stamp[*p] = scratch.round;
+                if (mayReach(ca, *p)) scratch.stack.push_back(*p);
+            }
+        }
+        return false;
+    }
+};
+
+class ReachLabels {
+private:
+    std::vector<uint32_t> component_, predStart_, pred_, labels_;
+    mutable ReachScratch scratch_;
+
+public:
+    // Labels a graph with nodes nodes; successors(u) lists the nodes that
+    // require u.
+    template <class Successors>
+    void build(size_t nodes, Successors&& successors) {
+        Condensation dag;
+        dag.build(nodes, successors);
+        const uint32_t c = dag.size();
+        const std::vector<uint32_t>& succStart = dag.succStart();
+        const std::vector<uint32_t>& succ = dag.succ();
+        component_ = dag.components();
+
+        // Prerequisite rows, filled from the last position down.
+        predStart_.assign(c + 1, 0);
+        for (uint32_t v : succ) ++predStart_[v + 1];
+        for (uint32_t p = 0; p < c; ++p) predStart_[p + 1] += predStart_[p];
+        pred_.resize(succ.size());
+        {
+            std::vector<uint32_t> cursor(predStart_.begin(), predStart_.end() - 1);
+            for (uint32_t p = c; p-- > 0;)
+                for (uint32_t i = succStart[p]; i < succStart[p + 1]; ++i) pred_[cursor[succ[i]]++] = p;
+        }
+
+        labels_.assign((size_t)c * kReachFields, 0);
+        auto label = [&](uint32_t p, ReachField f) -> uint32_t& { return labels_[(size_t)p * kReachFields + f]; };
+
+        // Levels, in topological order.
+        for (uint32_t p = 0; p < c; ++p)
+            for (uint32_t i = succStart[p]; i < succStart[p + 1]; ++i)
+                label(succ[i], kReachLevel) = std::max(label(succ[i], kReachLevel), label(p, kReachLevel) + 1);
+        for (uint32_t p = 0; p < c; ++p)
+            if (dag.cyclic(p)) label(p, kReachLevel) |= kReachCyclic;
+
+        // Two post-order traversals from the sources: the first takes them
+        // and each row's children in order, the second in reverse.
+        std::vector<uint8_t> seen;
+        std::vector<std::pair<uint32_t, uint32_t>> stack;   // component, children taken
+        for (int t = 0; t < 2; ++t) {
+            const ReachField lowField = t ? kReachLow1 : kReachLow0, postField = t ? kReachPost1 : kReachPost0;
+            seen.assign(c, 0);
+            uint32_t post = 0;
+            for (uint32_t r = 0; r < c; ++r) {
+                const uint32_t root = t ? c - 1 - r : r;
+                if (predStart_[root] != predStart_[root + 1]) continue;
+                seen[root] = 1;
+                label(root, lowField) = UINT32_MAX;
+                if (t == 0) label(root, kReachTreeLow) = post;
+                stack.emplace_back(root, 0);
+                while (!stack.empty()) {
+                    const uint32_t x = stack.back().first, taken = stack.back().second;
+                    if (taken < succStart[x + 1] - succStart[x]) {
+                        ++stack.back().second;
+                        const uint32_t y = succ[t ? succStart[x + 1] - 1 - taken : succStart[x] + taken];
+                        if (seen[y]) {
+                            label(x, lowField) = std::min(label(x, lowField), label(y, lowField));
+                            continue;
+                        }
+                        seen[y] = 1;
+                        label(y, lowField) = UINT32_MAX;
+                        if (t == 0) label(y, kReachTreeLow) = post;
+                        stack.emplace_back(y, 0);
+                        continue;
+                    }
+                    stack.pop_back();
+                    label(x, postField) = post++;
+                    label(x, lowField) = std::min(label(x, lowField), label(x, postField));
+                    if (!stack.empty()) {
+                        uint32_t& parentLow = label(stack.back().first, lowField);
+                        parentLow = std::min(parentLow, label(x, lowField));
+                    }
+                }
+            }
+        }
+    }
+
+    void clear() {
+        component_.clear();
+        predStart_.clear();
+        pred_.clear();
+        labels_.clear();
+    }
+
+    ReachView view() const {
+        ReachView v;
+        v.component = component_.data();
+        v.predStart = predStart_.data();
+        v.pred = pred_.data();
+        v.labels = labels_.data();
+        v.nodes = (uint32_t)component_.size();
+        v.components = predStart_.empty() ? 0 : (uint32_t)predStart_.size() - 1;
+        return v;
+    }
+
+    // Shares one scratch, so one query at a time; threads should query
+    // view() with a scratch each.
+    bool reaches(uint32_t a, uint32_t v) const { return view().reaches(a, v, scratch_); }
+    bool mayReach(uint32_t a, uint32_t v) const { return view().mayReachNode(a, v); }
+
+    const std::vector<uint32_t>& components() const { return component_; }
+    const std::vector<uint32_t>& predStart() const { return predStart_; }
+    const std::vector<uint32_t>& pred() const { return pred_; }
+    const std::vector<uint32_t>& labels() const { return labels_; }
+
+    size_t memoryBytes() const {
+        return (component_.capacity() + predStart_.capacity() + pred_.capacity() + labels_.capacity() +
+            scratch_.stamp.capacity() + scratch_.stack.capacity()) * sizeof(uint32_t);
+    }
+};
@@ -0,0 +1,96 @@
+﻿// Simd.h
+// CS499 – Final ePortfolio Artifact (Advising Assistance Program)
+//
+// Description:
+// Runtime CPU feature detection and small bit helpers shared by the
+// vectorized kernels. Kernels are compiled for SSE4.2/AVX2 with
+// PT_TARGET(...) and selected at runtime, so the program still runs on
+// machines without those extensions (and on non-x86 builds, where only
+// the scalar paths exist).
+
+#pragma once
+
+#include <cstdint>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define PT_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#else
+#define PT_X86 0
+#endif
+
+// MSVC accepts intrinsics for any ISA without per-function flags; GCC and
+// Clang need the target attribute on the function that uses them.
+#if defined(_MSC_VER) && !defined(__clang__)
+#define PT_TARGET(isa)
+#else
+#define PT_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+struct CpuFeatures {
+    bool sse42 = false;
+    bool avx2 = false;
+
+    static const CpuFeatures& get() {
+        static const CpuFeatures f = detect();
+        return f;
+    }
+
+private:
+    static CpuFeatures detect() {
+        CpuFeatures f;
+#if PT_X86 && defined(_MSC_VER)
+        int r[4];
+        __cpuid(r, 0);
+        int maxLeaf = r[0];
+        __cpuid(r, 1);
+        f.sse42 = (r[2] & (1 << 20)) != 0;
+        bool osxsave = (r[2] & (1 << 27)) != 0;
+        bool avx = (r[2] & (1 << 28)) != 0;
+        if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 6) == 6) {
+            __cpuidex(r, 7, 0);
+            f.avx2 = (r[1] & (1 << 5)) != 0;
+        }
+#elif PT_X86
+        __builtin_cpu_init();
+        f.sse42 = __builtin_cpu_supports("sse4.2");
+        f.avx2 = __builtin_cpu_supports("avx2");
+#endif
+        return f;
+    }
+};
+
+// Index of the lowest set bit; x must be non-zero.
+static inline unsigned ctz64(uint64_t x) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long i;
+    _BitScanForward64(&i, x);
+    return (unsigned)i;
+#elif defined(_MSC_VER)
+    unsigned long i;
+    if (_BitScanForward(&i, (unsigned long)x)) return (unsigned)i;
+    _BitScanForward(&i, (unsigned long)(x >> 32));
+    return (unsigned)i + 32;
+#else
+    return (unsigned)__builtin_ctzll(x);
+#endif
+}
+
+// Index of the highest set bit; x must be non-zero.
+static inline unsigned msb64(uint64_t x) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long i;
+    _BitScanReverse64(&i, x);
+    return (unsigned)i;
+#elif defined(_MSC_VER)
+    unsigned long i;
+    if (_BitScanReverse(&i, (unsigned long)(x >> 32))) return (unsigned)i + 32;
+    _BitScanReverse(&i, (unsigned long)x);
+    return (unsigned)i;
+#else
+    return 63u - (unsigned)__builtin_clzll(x);
+#endif
+}
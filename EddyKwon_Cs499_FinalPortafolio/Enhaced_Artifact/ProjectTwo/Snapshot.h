@@ -0,0 +1,595 @@
+﻿// Snapshot.h
+// CS499 – Final ePortfolio Artifact (Advising Assistance Program)
+//
+// Description:
+// Binary catalog snapshot. A loaded catalog (codes, titles, prerequisite
+// lists, the prerequisite graph and a lookup hash table) is written as
+// flat arrays addressed by file offsets, so a restarted process can mmap
+// the file and answer queries straight from the mapping: no CSV parsing,
+// no string allocation and no rehashing.
+//
+// Layout (little-endian, every section 8-byte aligned):
+//   SnapshotHeader   magic, version, sizes, checksum, section table
+//   codeOffsets      uint32[codeCount + 1]  into codeBytes
+//   codeBytes        canonical codes; ids [0, courseCount) are the courses
+//                    in sorted order, the rest are prerequisite-only codes
+//   titleOffsets     uint32[courseCount + 1] into titleBytes
+//   titleBytes
+//   prereqOffsets    uint32[courseCount + 1] into prereqIds
+//   prereqIds        code ids, in CSV order
+//   succOffsets      uint32[courseCount + 1] into succIds: the courses each
+//                    course unlocks (Catalog::graph() successors)
+//   succIds          course ids
+//   indegree         uint32[courseCount]
+//   hashSlots        uint32[hashMask + 1]; 0 = empty, otherwise id + 1
+//   mphPilots        optional minimal perfect hash over the course codes
+//   mphRemap         (see PerfectHash.h; keys hashed with codeHash), and
+//   mphIds           uint32[courseCount]: perfect-hash position -> id
+//   completeIds      uint32[courseCount]: course ids by (length, code)
+//   completeHeads    uint64[courseCount]: codeHead of each (CodeCompleter.h)
+//   completeLengths  uint32[L + 1]: start of each code length in completeIds
+//   titleTermOffsets uint32[T + 1] into titleTermBytes: the title index's
+//   titleTermBytes   vocabulary in byte order (see TitleIndex.h)
+//   titleTermBlocks  uint32[T + 1]: first posting block of each term
+//   titleTermDocs    uint32[T]: courses per term
+//   titleBlockLast   uint32[B]: last course id of each block
+//   titleBlockOffsets uint32[B + 1] into titlePostings
+//   titlePostings    varint-coded posting blocks
+//   titleDocLength   uint16[courseCount]: terms in each title
+//   titleStats       uint64[2]: titled courses, total title terms
+//   fuzzyIds         uint32[N]: BK-tree nodes' course ids (FuzzyIndex.h)
+//   fuzzyEdges       uint32[N]: each node's distance to its parent
+//   fuzzyChildren    uint32[N + 1]: first child of each node
+//   fuzzyCodeOffsets uint32[N + 1] into fuzzyCodeBytes
+//   fuzzyCodeBytes   node codes in node order
+//   reachComponents  uint32[courseCount]: each course's component in the
+//                    condensed successor graph (ReachLabels.h)
+//   reachPredOffsets uint32[C + 1] into reachPredIds
+//   reachPredIds     components each component requires, descending
+//   reachLabels      uint32[C * kReachFields]: levels and intervals
+//
+// A snapshot written from a frozen catalog carries the mph* sections and
+// lookups use them; otherwise they are empty and hashSlots is probed.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "CodeCompleter.h"
+#include "CourseCode.h"
+#include "FuzzyIndex.h"
+#include "Interner.h"
+#include "MappedFile.h"
+#include "PerfectHash.h"
+#include "ReachLabels.h"
+#include "TitleIndex.h"
+
+static const char kSnapshotMagic[8] = { 'P', 'T', 'C', 'A', 'T', 'S', 'N', 'P' };
+static const uint32_t kSnapshotVersion = 6;
+static const uint32_t kSnapshotEndianTag = 0x01020304;
+
+enum SnapshotSectionId : uint32_t {
+    kSnapCodeOffsets,
+    kSnapCodeBytes,
+    kSnapTitleOffsets,
+    kSnapTitleBytes,
+    kSnapPrereqOffsets,
+    kSnapPrereqIds,
+    kSnapSuccOffsets,
+    kSnapSuccIds,
+    kSnapIndegree,
+    kSnapHashSlots,
+    kSnapMphPilots,
+    kSnapMphRemap,
+    kSnapMphIds,
+    kSnapCompleteIds,
+    kSnapCompleteHeads,
+    kSnapCompleteLengths,
+    kSnapTitleTermOffsets,
+    kSnapTitleTermBytes,
+    kSnapTitleTermBlocks,
+    kSnapTitleTermDocs,
+    kSnapTitleBlockLast,
+    kSnapTitleBlockOffsets,
+    kSnapTitlePostings,
+    kSnapTitleDocLength,
+    kSnapTitleStats,
+    kSnapFuzzyIds,
+    kSnapFuzzyEdges,
+    kSnapFuzzyChildren,
+    kSnapFuzzyCodeOffsets,
+    kSnapFuzzyCodeBytes,
+    kSnapReachComponents,
+    kSnapReachPredOffsets,
+    kSnapReachPredIds,
+    kSnapReachLabels,
+    kSnapSectionCount
+};
+
+struct SnapshotSection {
+    uint64_t offset;
+    uint64_t size;
+};
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t endianTag;
+    uint64_t fileSize;
+    uint64_t checksum;      // snapshotChecksum of every byte after the header
+    uint32_t courseCount;
+    uint32_t codeCount;
+    uint32_t hashMask;
+    uint32_t reserved;
+    SnapshotSection sections[kSnapSectionCount];
+};
+
+static_assert(sizeof(SnapshotHeader) == 48 + 16 * kSnapSectionCount, "snapshot header must stay packed");
+
+// FNV-1a over the canonical code; stable across builds and platforms.
+static inline uint64_t snapshotHash(std::string_view s) {
+    uint64_t h = 1469598103934665603ull;
+    for (unsigned char ch : s) {
+        h ^= ch;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+// Word-at-a-time multiply/rotate checksum; detects truncation and bit rot.
+static inline uint64_t snapshotChecksum(const char* p, size_t n) {
+    uint64_t h = 0x9E3779B97F4A7C15ull ^ n;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint64_t w;
+        std::memcpy(&w, p + i, 8);
+        h = (h ^ w) * 0xFF51AFD7ED558CCDull;
+        h ^= h >> 29;
+    }
+    uint64_t tail = 0;
+    std::memcpy(&tail, p + i, n - i);
+    h = (h ^ tail) * 0xC4CEB9FE1A85EC53ull;
+    return h ^ (h >> 32);
+}
+
+// Everything the writer needs, already resolved to ids.
+struct SnapshotData {
+    uint32_t courseCount = 0;
+    std::vector<std::string> codes;         // sorted courses, then extras
+    std::vector<std::string> titles;        // courseCount entries
+    std::vector<uint32_t> prereqOffsets;    // courseCount + 1
+    std::vector<uint32_t> prereqIds;
+    std::vector<uint32_t> succOffsets;      // courseCount + 1
+    std::vector<uint32_t> succIds;
+    std::vector<uint32_t> indegree;         // courseCount
+    std::vector<uint32_t> mphPilots;        // empty = no perfect hash
+    std::vector<uint32_t> mphRemap;
+    std::vector<uint32_t> mphIds;           // courseCount when present
+    std::vector<uint32_t> completeIds;      // courseCount
+    std::vector<uint64_t> completeHeads;    // courseCount
+    std::vector<uint32_t> completeLengthStart;
+    std::vector<uint32_t> titleTermOffsets;  // title index over course ids
+    std::string titleTermBytes;
+    std::vector<uint32_t> titleTermBlocks;
+    std::vector<uint32_t> titleTermDocs;
+    std::vector<uint32_t> titleBlockLast;
+    std::vector<uint32_t> titleBlockOffsets;
+    std::vector<uint8_t> titlePostings;
+    std::vector<uint16_t> titleDocLength;   // courseCount
+    uint64_t titleStats[2] = {};            // indexed courses, total terms
+    std::vector<uint32_t> fuzzyIds;         // BK-tree over course ids
+    std::vector<uint32_t> fuzzyEdges;
+    std::vector<uint32_t> fuzzyChildStart;
+    std::vector<uint32_t> fuzzyCodeOffsets;
+    std::string fuzzyCodeBytes;
+    std::vector<uint32_t> reachComponents;  // labels over course ids
+    std::vector<uint32_t> reachPredStart;
+    std::vector<uint32_t> reachPred;
+    std::vector<uint32_t> reachLabels;
+};
+
+namespace snapshot {
+
+template <class T>
+static void appendSection(std::string& out, SnapshotHeader& h, SnapshotSectionId id, const T* data, size_t count) {
+    out.resize((out.size() + 7) & ~(size_t)7, '\0');
+    h.sections[id].offset = out.size();
+    h.sections[id].size = count * sizeof(T);
+    if (count) out.append((const char*)data, count * sizeof(T));
+}
+
+static void appendStrings(std::string& out, SnapshotHeader& h, SnapshotSectionId offsId, SnapshotSectionId bytesId,
+    const std::vector<std::string>& strs) {
+    std::vector<uint32_t> offs;
+    offs.reserve(strs.size() + 1);
+    std::string bytes;
+    for (const auto& s : strs) {
+        offs.push_back((uint32_t)bytes.size());
+        bytes += s;
+    }
+    offs.push_back((uint32_t)bytes.size());
+    appendSection(out, h, offsId, offs.data(), offs.size());
+    appendSection(out, h, bytesId, bytes.data(), bytes.size());
+}
+
+} // namespace snapshot
+
+// Serializes data to path. The file is written next to the target and
+// renamed into place, so readers never observe a half-written snapshot.
+static inline bool writeSnapshot(const std::string& path, const SnapshotData& data) {
+    SnapshotHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, kSnapshotMagic, sizeof(h.magic));
+    h.version = kSnapshotVersion;
+    h.endianTag = kSnapshotEndianTag;
+    h.courseCount = data.courseCount;
+    h.codeCount = (uint32_t)data.codes.size();
+
+    uint32_t capacity = 16;
+    while (capacity < data.courseCount * 2u) capacity <<= 1;
+    h.hashMask = capacity - 1;
+    std::vector<uint32_t> slots(capacity, 0);
+    for (uint32_t id = 0; id < data.courseCount; ++id) {
+        uint32_t i = (uint32_t)snapshotHash(data.codes[id]) & h.hashMask;
+        while (slots[i]) i = (i + 1) & h.hashMask;
+        slots[i] = id + 1;
+    }
+
+    std::string out(sizeof(SnapshotHeader), '\0');
+    snapshot::appendStrings(out, h, kSnapCodeOffsets, kSnapCodeBytes, data.codes);
+    snapshot::appendStrings(out, h, kSnapTitleOffsets, kSnapTitleBytes, data.titles);
+    snapshot::appendSection(out, h, kSnapPrereqOffsets, data.prereqOffsets.data(), data.prereqOffsets.size());
+    snapshot::appendSection(out, h, kSnapPrereqIds, data.prereqIds.data(), data.prereqIds.size());
+    snapshot::appendSection(out, h, kSnapSuccOffsets, data.succOffsets.data(), data.succOffsets.size());
+    snapshot::appendSection(out, h, kSnapSuccIds, data.succIds.data(), data.succIds.size());
+    snapshot::appendSection(out, h, kSnapIndegree, data.indegree.data(), data.indegree.size());
+    snapshot::appendSection(out, h, kSnapHashSlots, slots.data(), slots.size());
+    snapshot::appendSection(out, h, kSnapMphPilots, data.mphPilots.data(), data.mphPilots.size());
+    snapshot::appendSection(out, h, kSnapMphRemap, data.mphRemap.data(), data.mphRemap.size());
+    snapshot::appendSection(out, h, kSnapMphIds, data.mphIds.data(), data.mphIds.size());
+    snapshot::appendSection(out, h, kSnapCompleteIds, data.completeIds.data(), data.completeIds.size());
+    snapshot::appendSection(out, h, kSnapCompleteHeads, data.completeHeads.data(), data.completeHeads.size());
+    snapshot::appendSection(out, h, kSnapCompleteLengths, data.completeLengthStart.data(), data.completeLengthStart.size());
+    snapshot::appendSection(out, h, kSnapTitleTermOffsets, data.titleTermOffsets.data(), data.titleTermOffsets.size());
+    snapshot::appendSection(out, h, kSnapTitleTermBytes, data.titleTermBytes.data(), data.titleTermBytes.size());
+    snapshot::appendSection(out, h, kSnapTitleTermBlocks, data.titleTermBlocks.data(), data.titleTermBlocks.size());
+    snapshot::appendSection(out, h, kSnapTitleTermDocs, data.titleTermDocs.data(), data.titleTermDocs.size());
+    snapshot::appendSection(out, h, kSnapTitleBlockLast, data.titleBlockLast.data(), data.titleBlockLast.size());
+    snapshot::appendSection(out, h, kSnapTitleBlockOffsets, data.titleBlockOffsets.data(), data.titleBlockOffsets.size());
+    snapshot::appendSection(out, h, kSnapTitlePostings, data.titlePostings.data(), data.titlePostings.size());
+    snapshot::appendSection(out, h, kSnapTitleDocLength, data.titleDocLength.data(), data.titleDocLength.size());
+    snapshot::appendSection(out, h, kSnapTitleStats, data.titleStats, 2);
+    snapshot::appendSection(out, h, kSnapFuzzyIds, data.fuzzyIds.data(), data.fuzzyIds.size());
+    snapshot::appendSection(out, h, kSnapFuzzyEdges, data.fuzzyEdges.data(), data.fuzzyEdges.size());
+    snapshot::appendSection(out, h, kSnapFuzzyChildren, data.fuzzyChildStart.data(), data.fuzzyChildStart.size());
+    snapshot::appendSection(out, h, kSnapFuzzyCodeOffsets, data.fuzzyCodeOffsets.data(), data.fuzzyCodeOffsets.size());
+    snapshot::appendSection(out, h, kSnapFuzzyCodeBytes, data.fuzzyCodeBytes.data(), data.fuzzyCodeBytes.size());
+    snapshot::appendSection(out, h, kSnapReachComponents, data.reachComponents.data(), data.reachComponents.size());
+    snapshot::appendSection(out, h, kSnapReachPredOffsets, data.reachPredStart.data(), data.reachPredStart.size());
+    snapshot::appendSection(out, h, kSnapReachPredIds, data.reachPred.data(), data.reachPred.size());
+    snapshot::appendSection(out, h, kSnapReachLabels, data.reachLabels.data(), data.reachLabels.size());
+    out.resize((out.size() + 7) & ~(size_t)7, '\0');
+
+    h.fileSize = out.size();
+    h.checksum = snapshotChecksum(out.data() + sizeof(h), out.size() - sizeof(h));
+    std::memcpy(&out[0], &h, sizeof(h));
+
+    std::string tmp = path + ".tmp";
+    {
+        std::ofstream fout(tmp, std::ios::binary | std::ios::trunc);
+        if (!fout.is_open()) return false;
+        fout.write(out.data(), (std::streamsize)out.size());
+        if (!fout) return false;
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
+// Read-only catalog served directly from a mapped snapshot file.
+class SnapshotView {
+private:
+    MappedFile file_;
+    const SnapshotHeader* header_ = nullptr;
+    PerfectHashView perfect_;       // empty when the file has no mph sections
+    CompletionView completion_;
+    TitleIndexView titles_;
+    FuzzyView fuzzy_;
+    ReachView reach_;
+
+    // Search state for reaches(); one query at a time per view.
+    mutable ReachScratch reachScratch_;
+
+    template <class T>
+    const T* section(SnapshotSectionId id) const {
+        return (const T*)(file_.data() + header_->sections[id].offset);
+    }
+
+    bool sectionFits(SnapshotSectionId id, uint64_t expectedSize) const {
+        const SnapshotSection& s = header_->sections[id];
+        return s.offset % 8 == 0 && s.offset <= file_.size() && s.size <= file_.size() - s.offset &&
+            (expectedSize == UINT64_MAX || s.size == expectedSize);
+    }
+
+public:
+    static constexpr uint32_t npos = UINT32_MAX;
+
+    // Maps and validates path. On failure the view stays closed and
+    // error explains why (unknown format, wrong version, bad checksum...).
+    bool open(const std::string& path, std::string& error) {
+        close();
+        if (!file_.open(path)) { error = "cannot open file"; return false; }
+        if (file_.size() < sizeof(SnapshotHeader)) { error = "file too small"; close(); return false; }
+
+        header_ = (const SnapshotHeader*)file_.data();
+        const SnapshotHeader& h = *header_;
+        if (std::memcmp(h.magic, kSnapshotMagic, sizeof(h.magic)) != 0) { error = "not a catalog snapshot"; close(); return false; }
+        if (h.endianTag != kSnapshotEndianTag) { error = "byte order mismatch"; close(); return false; }
+        if (h.version != kSnapshotVersion) {
+            error = "unsupported version " + std::to_string(h.version);
+            close();
+            return false;
+        }
+        if (h.fileSize != file_.size()) { error = "truncated file"; close(); return false; }
+        if (h.checksum != snapshotChecksum(file_.data() + sizeof(h), file_.size() - sizeof(h))) {
+            error = "checksum mismatch";
+            close();
+            return false;
+        }
+
+        uint64_t n = h.courseCount, m = h.codeCount;
+        bool ok = n <= m &&
+            sectionFits(kSnapCodeOffsets, (m + 1) * 4) && sectionFits(kSnapCodeBytes, UINT64_MAX) &&
+            sectionFits(kSnapTitleOffsets, (n + 1) * 4) && sectionFits(kSnapTitleBytes, UINT64_MAX) &&
+            sectionFits(kSnapPrereqOffsets, (n + 1) * 4) && sectionFits(kSnapPrereqIds, UINT64_MAX) &&
+            sectionFits(kSnapSuccOffsets, (n + 1) * 4) && sectionFits(kSnapSuccIds, UINT64_MAX) &&
+            sectionFits(kSnapIndegree, n * 4) && sectionFits(kSnapHashSlots, ((uint64_t)h.hashMask + 1) * 4) &&
+            ((h.hashMask + 1) & h.hashMask) == 0;
+        ok = ok &&
+            section<uint32_t>(kSnapCodeOffsets)[m] <= h.sections[kSnapCodeBytes].size &&
+            section<uint32_t>(kSnapTitleOffsets)[n] <= h.sections[kSnapTitleBytes].size &&
+            section<uint32_t>(kSnapPrereqOffsets)[n] * 4ull <= h.sections[kSnapPrereqIds].size &&
+            section<uint32_t>(kSnapSuccOffsets)[n] * 4ull <= h.sections[kSnapSuccIds].size;
+        if (!ok) { error = "corrupt section table"; close(); return false; }
+
+        // Every offset array must be non-decreasing and every id in range,
+        // so code(), title() and the graph rows stay inside their sections;
+        // the indegrees must count the successor rows. The hash table may
+        // hold only course ids and needs an empty slot to end every probe.
+        auto ascending = [&](SnapshotSectionId id, uint64_t entries) {
+            const uint32_t* offs = section<uint32_t>(id);
+            for (uint64_t i = 0; i < entries; ++i)
+                if (offs[i] > offs[i + 1]) return false;
+            return true;
+        };
+        ok = ascending(kSnapCodeOffsets, m) && ascending(kSnapTitleOffsets, n) &&
+            ascending(kSnapPrereqOffsets, n) && ascending(kSnapSuccOffsets, n);
+        {
+            const uint32_t* prereqIds = section<uint32_t>(kSnapPrereqIds);
+            const uint32_t* succIds = section<uint32_t>(kSnapSuccIds);
+            const uint32_t* indegree = section<uint32_t>(kSnapIndegree);
+            const uint32_t* slots = section<uint32_t>(kSnapHashSlots);
+            for (uint32_t i = 0, e = section<uint32_t>(kSnapPrereqOffsets)[n]; ok && i < e; ++i) ok = prereqIds[i] < m;
+            std::vector<uint32_t> counted(ok ? n : 0, 0);
+            for (uint32_t i = 0, e = section<uint32_t>(kSnapSuccOffsets)[n]; ok && i < e; ++i)
+                ok = succIds[i] < n && ++counted[succIds[i]] <= indegree[succIds[i]];
+            for (uint64_t i = 0; ok && i < n; ++i) ok = counted[i] == indegree[i];
+            bool emptySlot = false;
+            for (uint64_t i = 0; ok && i <= h.hashMask; ++i) {
+                ok = slots[i] <= n;
+                emptySlot = emptySlot || slots[i] == 0;
+            }
+            ok = ok && emptySlot;
+        }
+        if (!ok) { error = "corrupt course data"; close(); return false; }
+
+        perfect_ = PerfectHashView();
+        uint64_t pilots = h.sections[kSnapMphPilots].size / 4, remap = h.sections[kSnapMphRemap].size / 4;
+        if (pilots > 0) {
+            ok = n > 0 && sectionFits(kSnapMphPilots, pilots * 4) && sectionFits(kSnapMphRemap, remap * 4) &&
+                sectionFits(kSnapMphIds, n * 4) && n + remap <= UINT32_MAX;
+            const uint32_t* remapIds = ok ? section<uint32_t>(kSnapMphRemap) : nullptr;
+            const uint32_t* ids = ok ? section<uint32_t>(kSnapMphIds) : nullptr;
+            for (uint64_t i = 0; ok && i < remap; ++i) ok = remapIds[i] < n;
+            for (uint64_t i = 0; ok && i < n; ++i) ok = ids[i] < n;
+            if (!ok) { error = "corrupt perfect hash"; close(); return false; }
+            perfect_.pilots = section<uint32_t>(kSnapMphPilots);
+            perfect_.remap = remapIds;
+            perfect_.buckets = (uint32_t)pilots;
+            perfect_.keys = (uint32_t)n;
+            perfect_.tableSize = (uint32_t)(n + remap);
+        }
+
+        completion_ = CompletionView();
+        uint64_t lengths = h.sections[kSnapCompleteLengths].size / 4;
+        ok = lengths >= 1 && sectionFits(kSnapCompleteIds, n * 4) && sectionFits(kSnapCompleteHeads, n * 8) &&
+            sectionFits(kSnapCompleteLengths, lengths * 4);
+        const uint32_t* starts = ok ? section<uint32_t>(kSnapCompleteLengths) : nullptr;
+        const uint32_t* completeIds = ok ? section<uint32_t>(kSnapCompleteIds) : nullptr;
+        ok = ok && starts[0] == 0 && starts[lengths - 1] == n;
+        for (uint64_t i = 1; ok && i < lengths; ++i) ok = starts[i - 1] <= starts[i];
+        for (uint64_t i = 0; ok && i < n; ++i) ok = completeIds[i] < n;
+        if (!ok) { error = "corrupt completion index"; close(); return false; }
+        completion_.ids = completeIds;
+        completion_.heads = section<uint64_t>(kSnapCompleteHeads);
+        completion_.lengthStart = starts;
+        completion_.lengths = (uint32_t)(lengths - 1);
+
+        titles_ = TitleIndexView();
+        uint64_t terms = h.sections[kSnapTitleTermDocs].size / 4, blocks = h.sections[kSnapTitleBlockLast].size / 4;
+        ok = sectionFits(kSnapTitleTermOffsets, (terms + 1) * 4) && sectionFits(kSnapTitleTermBytes, UINT64_MAX) &&
+            sectionFits(kSnapTitleTermBlocks, (terms + 1) * 4) && sectionFits(kSnapTitleTermDocs, terms * 4) &&
+            sectionFits(kSnapTitleBlockLast, blocks * 4) && sectionFits(kSnapTitleBlockOffsets, (blocks + 1) * 4) &&
+            sectionFits(kSnapTitlePostings, UINT64_MAX) && sectionFits(kSnapTitleDocLength, n * 2) &&
+            sectionFits(kSnapTitleStats, 16) && terms < UINT32_MAX;
+        const uint32_t* termOffsets = ok ? section<uint32_t>(kSnapTitleTermOffsets) : nullptr;
+        const uint32_t* termBlocks = ok ? section<uint32_t>(kSnapTitleTermBlocks) : nullptr;
+        const uint32_t* blockOffsets = ok ? section<uint32_t>(kSnapTitleBlockOffsets) : nullptr;
+        const uint64_t* stats = ok ? section<uint64_t>(kSnapTitleStats) : nullptr;
+        ok = ok && termOffsets[0] == 0 && termOffsets[terms] <= h.sections[kSnapTitleTermBytes].size &&
+            termBlocks[0] == 0 && termBlocks[terms] == blocks && blockOffsets[0] == 0 &&
+            blockOffsets[blocks] <= h.sections[kSnapTitlePostings].size && stats[0] <= n;
+        for (uint64_t i = 0; ok && i < terms; ++i)
+            ok = termOffsets[i] <= termOffsets[i + 1] && termBlocks[i] <= termBlocks[i + 1];
+        for (uint64_t i = 0; ok && i < blocks; ++i) ok = blockOffsets[i] <= blockOffsets[i + 1];
+        if (!ok) { error = "corrupt title index"; close(); return false; }
+        titles_.termOffsets = termOffsets;
+        titles_.termBytes = section<char>(kSnapTitleTermBytes);
+        titles_.termBlocks = termBlocks;
+        titles_.termDocs = section<uint32_t>(kSnapTitleTermDocs);
+        titles_.blockLast = section<uint32_t>(kSnapTitleBlockLast);
+        titles_.blockOffset = blockOffsets;
+        titles_.postings = section<uint8_t>(kSnapTitlePostings);
+        titles_.docLength = section<uint16_t>(kSnapTitleDocLength);
+        titles_.terms = (uint32_t)terms;
+        titles_.docs = (uint32_t)n;
+        titles_.indexedDocs = (uint32_t)stats[0];
+        titles_.avgLength = stats[0] ? (double)stats[1] / (double)stats[0] : 0.0;
+
+        // BK-tree nodes are breadth-first: children come after their parent,
+        // which also rules out cycles.
+        fuzzy_ = FuzzyView();
+        uint64_t nodes = h.sections[kSnapFuzzyIds].size / 4, links = nodes ? nodes + 1 : 0;
+        ok = nodes <= n && sectionFits(kSnapFuzzyIds, nodes * 4) && sectionFits(kSnapFuzzyEdges, nodes * 4) &&
+            sectionFits(kSnapFuzzyChildren, links * 4) && sectionFits(kSnapFuzzyCodeOffsets, links * 4) &&
+            sectionFits(kSnapFuzzyCodeBytes, UINT64_MAX);
+        const uint32_t* fuzzyIds = ok ? section<uint32_t>(kSnapFuzzyIds) : nullptr;
+        const uint32_t* children = ok ? section<uint32_t>(kSnapFuzzyChildren) : nullptr;
+        const uint32_t* codeOffsets = ok ? section<uint32_t>(kSnapFuzzyCodeOffsets) : nullptr;
+        ok = ok && (nodes == 0 || (children[nodes] == nodes && codeOffsets[0] == 0 &&
+            codeOffsets[nodes] <= h.sections[kSnapFuzzyCodeBytes].size));
+        for (uint64_t i = 0; ok && i < nodes; ++i)
+            ok = fuzzyIds[i] < n && children[i] > i && children[i] <= children[i + 1] &&
+                codeOffsets[i] <= codeOffsets[i + 1];
+        if (!ok) { error = "corrupt fuzzy index"; close(); return false; }
+        fuzzy_.ids = fuzzyIds;
+        fuzzy_.edges = section<uint32_t>(kSnapFuzzyEdges);
+        fuzzy_.childStart = children;
+        fuzzy_.codeOffsets = codeOffsets;
+        fuzzy_.codeBytes = section<char>(kSnapFuzzyCodeBytes);
+        fuzzy_.nodes = (uint32_t)nodes;
+
+        // Reachability labels over the courses. Every row must list earlier
+        // components in descending order, so searches only move back.
+        reach_ = ReachView();
+        uint64_t components = h.sections[kSnapReachPredOffsets].size / 4;
+        components = components ? components - 1 : 0;
+        ok = components <= n && sectionFits(kSnapReachComponents, n * 4) &&
+            sectionFits(kSnapReachPredOffsets, (components + 1) * 4) && sectionFits(kSnapReachPredIds, UINT64_MAX) &&
+            sectionFits(kSnapReachLabels, components * kReachFields * 4);
+        const uint32_t* reachComponents = ok ? section<uint32_t>(kSnapReachComponents) : nullptr;
+        const uint32_t* predStart = ok ? section<uint32_t>(kSnapReachPredOffsets) : nullptr;
+        const uint32_t* pred = ok ? section<uint32_t>(kSnapReachPredIds) : nullptr;
+        ok = ok && predStart[0] == 0 && predStart[components] * 4ull == h.sections[kSnapReachPredIds].size;
+        for (uint64_t i = 0; ok && i < n; ++i) ok = reachComponents[i] < components;
+        for (uint64_t p = 0; ok && p < components; ++p) {
+            ok = predStart[p] <= predStart[p + 1] && predStart[p + 1] <= predStart[components];
+            for (uint32_t i = predStart[p]; ok && i < predStart[p + 1]; ++i)
+                ok = pred[i] < (i > predStart[p] ? pred[i - 1] : p);
+        }
+        if (!ok) { error = "corrupt reachability labels"; close(); return false; }
+        reach_.component = reachComponents;
+        reach_.predStart = predStart;
+        reach_.pred = pred;
+        reach_.labels = section<uint32_t>(kSnapReachLabels);
+        reach_.nodes = (uint32_t)n;
+        reach_.components = (uint32_t)components;
+        return true;
+    }
+
+    void close() {
+        file_.close();
+        header_ = nullptr;
+        perfect_ = PerfectHashView();
+        completion_ = CompletionView();
+        titles_ = TitleIndexView();
+        fuzzy_ = FuzzyView();
+        reach_ = ReachView();
+        reachScratch_ = ReachScratch();
+    }
+
+    bool hasPerfectHash() const { return !perfect_.empty(); }
+
+    bool isOpen() const { return header_ != nullptr; }
+    uint32_t size() const { return header_ ? header_->courseCount : 0; }
+    bool empty() const { return size() == 0; }
+
+    // Course ids are [0, size()) in sorted code order.
+    std::string_view code(uint32_t id) const {
+        const uint32_t* offs = section<uint32_t>(kSnapCodeOffsets);
+        return std::string_view(section<char>(kSnapCodeBytes) + offs[id], offs[id + 1] - offs[id]);
+    }
+    std::string_view title(uint32_t id) const {
+        const uint32_t* offs = section<uint32_t>(kSnapTitleOffsets);
+        return std::string_view(section<char>(kSnapTitleBytes) + offs[id], offs[id + 1] - offs[id]);
+    }
+    IdSpan prereqs(uint32_t id) const {
+        const uint32_t* offs = section<uint32_t>(kSnapPrereqOffsets);
+        const uint32_t* ids = section<uint32_t>(kSnapPrereqIds);
+        return { ids + offs[id], ids + offs[id + 1] };
+    }
+    IdSpan successors(uint32_t id) const {
+        const uint32_t* offs = section<uint32_t>(kSnapSuccOffsets);
+        const uint32_t* ids = section<uint32_t>(kSnapSuccIds);
+        return { ids + offs[id], ids + offs[id + 1] };
+    }
+    uint32_t indegree(uint32_t id) const { return section<uint32_t>(kSnapIndegree)[id]; }
+
+    // True if course a is required, directly or indirectly, by course v
+    // (see ReachLabels.h).
+    bool reaches(uint32_t a, uint32_t v) const { return reach_.reaches(a, v, reachScratch_); }
+
+    // The labels alone: false proves course a is not required by v.
+    bool mayReach(uint32_t a, uint32_t v) const { return reach_.mayReachNode(a, v); }
+
+    // Looks up a canonical code: one perfect-hash evaluation when the file
+    // has one, otherwise a probe of the stored hash table.
+    uint32_t find(std::string_view canonical) const {
+        if (!perfect_.empty()) {
+            uint32_t id = section<uint32_t>(kSnapMphIds)[perfect_(codeHash(canonical))];
+            return code(id) == canonical ? id : npos;
+        }
+        const uint32_t* slots = section<uint32_t>(kSnapHashSlots);
+        uint32_t mask = header_->hashMask;
+        for (uint32_t i = (uint32_t)snapshotHash(canonical) & mask; slots[i]; i = (i + 1) & mask) {
+            uint32_t id = slots[i] - 1;
+            if (id < size() && code(id) == canonical) return id;
+        }
+        return npos;
+    }
+
+    // Up to k course ids whose codes start with the canonical prefix
+    // (see CompletionView::complete); returns how many were passed to fn.
+    template <class Fn>
+    size_t complete(std::string_view prefix, size_t k, Fn&& fn) const {
+        return completion_.complete(prefix, k, [&](uint32_t id) { return code(id); }, fn);
+    }
+
+    // Calls fn(id, distance) for up to k course ids whose codes are within
+    // fuzzyRadius of the canonical code, closest first and then in id
+    // (code) order; returns how many.
+    template <class Fn>
+    size_t nearest(std::string_view canonical, size_t k, Fn&& fn) const {
+        auto hits = fuzzy_.nearest(canonical, fuzzyRadius(canonical), k, [](uint32_t a, uint32_t b) { return a < b; });
+        for (const auto& h : hits) fn(h.first, h.second);
+        return hits.size();
+    }
+
+    // The k best courses whose titles hold every term of query, best first
+    // with equal scores in id (code) order; returns how many matched in all
+    // (see TitleIndexView::search).
+    size_t searchTitles(std::string_view query, size_t k, std::vector<TitleIndexView::Hit>& out) const {
+        return titles_.search(query, k, [](uint32_t a, uint32_t b) { return a < b; }, out);
+    }
+};
@@ -0,0 +1,1121 @@
+﻿// Tests.cpp
+// CS499 – Final ePortfolio Artifact (Advising Assistance Program)
+//
+// Description:
+// Self-tests run with --test NAME, or --test all. Each checks one
+// structure of the planner against the plainest code that gives the same
+// answer, on small synthetic inputs (see Bench.h), and prints what
+// differed when it fails. --bench NAME times the same pairs at full size.
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Bench.h"
+#include "Catalog.h"
+#include "CodeQuery.h"
+#include "Snapshot.h"
+
+// Prints what went wrong when ok is false; returns ok.
+static bool expect(bool ok, const std::string& what) {
+    if (!ok) std::cout << "  ! " << what << "\n";
+    return ok;
+}
+
+// Whether order holds each of nodes nodes once, every edge's prerequisite
+// before its course.
+static bool isTopological(const std::vector<uint32_t>& order, uint32_t nodes, const EdgeList& edges) {
+    if (order.size() != nodes) return false;
+    std::vector<uint32_t> position(nodes, UINT32_MAX);
+    for (uint32_t i = 0; i < nodes; ++i) {
+        if (order[i] >= nodes || position[order[i]] != UINT32_MAX) return false;
+        position[order[i]] = i;
+    }
+    for (const auto& e : edges)
+        if (position[e.first] > position[e.second]) return false;
+    return true;
+}
+
+// A synthetic catalog in which every third course is defined twice in a
+// row and every tenth again near the end, so the rows of many codes fall
+// on both sides of a chunk border; the last row of a code wins.
+static std::string makeDuplicatedCSV(size_t courses) {
+    const std::string base = makeCatalogCSV(courses);
+    std::string csv, late;
+    Xorshift rng(5);
+    for (size_t pos = 0, i = 0; pos < base.size(); ++i) {
+        const size_t end = base.find('\n', pos) + 1;
+        const std::string line = base.substr(pos, end - pos), code = line.substr(0, line.find(','));
+        pos = end;
+        csv += line;
+        if (i % 3 == 0) csv += code + ",Revised " + std::to_string(i) + ",CSCI" + std::to_string(100000 + rng() % courses) + "\n";
+        if (i % 10 == 0) late += code + ",Late " + std::to_string(i) + "\n";
+    }
+    return csv + late;
+}
+
+// Same courses, titles and prerequisites, in the same order.
+static bool sameCatalog(const Catalog& a, const Catalog& b) {
+    if (a.size() != b.size()) return false;
+    for (auto x = a.begin(), y = b.begin(); x != a.end(); ++x, ++y) {
+        const Course& c = *x;
+        const Course& d = *y;
+        if (a.code(c.id()) != b.code(d.id()) || c.title() != d.title() || c.prereqs().size() != d.prereqs().size())
+            return false;
+        for (size_t i = 0; i < c.prereqs().size(); ++i)
+            if (a.code(c.prereqs()[i]) != b.code(d.prereqs()[i])) return false;
+    }
+    return true;
+}
+
+// Parallel ingest builds the catalog parseCourses does, whatever the
+// number of chunks.
+static bool testParallel() {
+    const std::string csv = makeDuplicatedCSV(5000);
+    Catalog expected;
+    parseCourses(csv, expected);
+
+    bool ok = true;
+    for (unsigned threads = 1; threads <= 8; ++threads) {
+        ThreadPool pool(threads);
+        Catalog got;
+        parseCoursesParallel(csv, got, pool);
+        ok = expect(sameCatalog(expected, got), std::to_string(pool.size() * 4) + " chunks: parallel ingest differs") && ok;
+    }
+    return ok;
+}
+
+// Every scan kernel splits and trims fields exactly as splitCSV does,
+// including lines longer than a block.
+static bool testSplitCSV() {
+    std::string buf = makeWideCSV(300, 12) + "\xEF\xBB\xBF" "CSCI100 , Intro,,MATH101,\n\nLAST, Row";
+    std::vector<std::vector<std::string>> expected;
+    for (size_t pos = 0; pos < buf.size();) {
+        size_t end = std::min(buf.find('\n', pos), buf.size());
+        expected.push_back(splitCSV(buf.substr(pos, end - pos)));
+        pos = end + 1;
+    }
+
+    bool ok = true;
+    for (const auto& k : csvKernels()) {
+        if (!k.supported) continue;
+        for (size_t blockSize : { (size_t)64, (size_t)64 * 1024 }) {
+            CsvScanner scanner(k.fn, blockSize);
+            std::vector<std::string_view> fields;
+            size_t row = 0;
+            bool same = true;
+            scanner.forEachRecord(buf, fields, [&](std::string_view, const std::vector<std::string_view>& f) {
+                same = same && row < expected.size() &&
+                    std::equal(f.begin(), f.end(), expected[row].begin(), expected[row].end());
+                ++row;
+            });
+            ok = expect(same && row == expected.size(), "scan/" + std::string(k.name) + " fields differ from splitCSV") && ok;
+        }
+    }
+    return ok;
+}
+
+// UTF-16 code units of mostly ASCII runs with accented, CJK and astral
+// characters and unpaired surrogates mixed in, and the UTF-8 the decoder
+// must make of them: U+FFFD for each unpaired surrogate.
+static void makeUtf16(size_t units, std::vector<uint16_t>& in, std::string& expected) {
+    auto put = [&](uint32_t cp) {
+        if (cp < 0x80) expected += (char)cp;
+        else if (cp < 0x800) expected.append({ (char)(0xC0 | cp >> 6), (char)(0x80 | (cp & 0x3F)) });
+        else if (cp < 0x10000)
+            expected.append({ (char)(0xE0 | cp >> 12), (char)(0x80 | (cp >> 6 & 0x3F)), (char)(0x80 | (cp & 0x3F)) });
+        else
+            expected.append({ (char)(0xF0 | cp >> 18), (char)(0x80 | (cp >> 12 & 0x3F)), (char)(0x80 | (cp >> 6 & 0x3F)),
+                (char)(0x80 | (cp & 0x3F)) });
+    };
+    Xorshift rng(7);
+    while (in.size() < units) {
+        const uint32_t astral = 0x1F600 + (uint32_t)(rng() % 64);
+        switch (rng() % 8) {
+        case 0: in.push_back(0xE9); put(0xE9); break;
+        case 1: in.push_back(0x6570); put(0x6570); break;
+        case 2:
+            in.push_back((uint16_t)(0xD800 + ((astral - 0x10000) >> 10)));
+            in.push_back((uint16_t)(0xDC00 + (astral & 0x3FF)));
+            put(astral);
+            break;
+        case 3: in.push_back((uint16_t)(0xDC00 + rng() % 0x400)); put(0xFFFD); break;
+        case 4: in.push_back((uint16_t)(0xD800 + rng() % 0x400)); put(0xFFFD); in.push_back('x'); put('x'); break;
+        default:
+            for (size_t n = rng() % 100; n > 0; --n) {
+                const char ch = (char)(' ' + rng() % 95);
+                in.push_back((uint16_t)ch);
+                put((uint32_t)ch);
+            }
+        }
+    }
+    // A high surrogate cut off by the end of the input.
+    in.push_back(0xD83D);
+    put(0xFFFD);
+}
+
+// Narrows nothing, which sends every code unit through the decoder's
+// scalar unit() path.
+static size_t noAsciiKernel(const unsigned char*, size_t, bool, char*) { return 0; }
+
+// Both byte orders are detected with and without a BOM, and decode to the
+// same UTF-8 through every ASCII kernel and through unit() alone, fed
+// whole or in slices of odd lengths that split units and surrogate pairs.
+static bool testEncoding() {
+    std::vector<uint16_t> units;
+    std::string expected;
+    makeUtf16(20000, units, expected);
+    std::vector<utf16::AsciiKernelInfo> kernels{ { "unit()", noAsciiKernel, true } };
+    for (const auto& k : utf16::asciiKernels())
+        if (k.supported) kernels.push_back(k);
+
+    bool ok = true;
+    for (bool bigEndian : { false, true }) {
+        std::string bytes;
+        for (uint16_t u : units) {
+            bytes += (char)(bigEndian ? u >> 8 : u & 0xFF);
+            bytes += (char)(bigEndian ? u & 0xFF : u >> 8);
+        }
+        const std::string name = bigEndian ? "UTF-16BE" : "UTF-16LE";
+        const TextEncoding encoding = bigEndian ? TextEncoding::Utf16BE : TextEncoding::Utf16LE;
+        const EncodingInfo plain = detectEncoding(bytes);
+        const EncodingInfo marked = detectEncoding((bigEndian ? "\xFE\xFF" : "\xFF\xFE") + bytes);
+        ok = expect(plain.encoding == encoding && plain.bomBytes == 0, name + " without a BOM not detected") && ok;
+        ok = expect(marked.encoding == encoding && marked.bomBytes == 2, name + " with a BOM not detected") && ok;
+
+        for (const auto& k : kernels)
+            for (size_t slice : { (size_t)1, (size_t)3, (size_t)37, (size_t)4096, bytes.size() }) {
+                Utf16ToUtf8 decoder(bigEndian, k.fn);
+                std::string out;
+                for (size_t pos = 0; pos < bytes.size(); pos += slice)
+                    decoder.feed(bytes.data() + pos, std::min(slice, bytes.size() - pos), out);
+                decoder.finish(out);
+                ok = expect(out == expected, name + " through " + k.name + " in slices of " + std::to_string(slice) +
+                    " bytes differs") && ok;
+            }
+    }
+
+    const EncodingInfo plain = detectEncoding(expected), marked = detectEncoding("\xEF\xBB\xBF" + expected);
+    ok = expect(plain.encoding == TextEncoding::Utf8 && plain.bomBytes == 0, "UTF-8 without a BOM not detected") && ok;
+    return expect(marked.encoding == TextEncoding::Utf8 && marked.bomBytes == 3, "UTF-8 with a BOM not detected") && ok;
+}
+
+// Writes bytes to path and opens them as a snapshot; true if the open
+// fails with an error that starts with expected.
+static bool rejects(const std::string& path, const std::string& bytes, const std::string& expected) {
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), (std::streamsize)bytes.size());
+    }
+    SnapshotView snap;
+    std::string error;
+    return !snap.open(path, error) && error.compare(0, expected.size(), expected) == 0;
+}
+
+// Damaged copies of a good snapshot: open() turns away a truncated file,
+// another version, a bad checksum and corrupt sections, including a hash
+// table with no empty slot to end a probe.
+static bool testSnapshotDamage(const std::string& good, const std::string& bad) {
+    std::string bytes;
+    {
+        std::ifstream in(good, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    SnapshotHeader h;
+    std::memcpy(&h, bytes.data(), sizeof(h));
+    // The file with header eh, and the checksum made to match its body.
+    auto edited = [](SnapshotHeader eh, std::string file) {
+        eh.checksum = snapshotChecksum(file.data() + sizeof(eh), file.size() - sizeof(eh));
+        std::memcpy(&file[0], &eh, sizeof(eh));
+        return file;
+    };
+
+    SnapshotHeader version = h, table = h;
+    ++version.version;
+    table.sections[kSnapPrereqIds].offset = bytes.size();
+    std::string flipped = bytes, slots = bytes, ids = bytes;
+    flipped.back() ^= 1;
+    uint32_t* slot = (uint32_t*)&slots[h.sections[kSnapHashSlots].offset];
+    for (uint64_t i = 0; i <= h.hashMask; ++i) slot[i] += slot[i] == 0;
+    *(uint32_t*)&ids[h.sections[kSnapPrereqIds].offset] = h.codeCount;
+
+    bool ok = expect(rejects(bad, bytes.substr(0, bytes.size() - 8), "truncated file"), "truncated file opened");
+    ok = expect(rejects(bad, edited(version, bytes), "unsupported version"), "another version opened") && ok;
+    ok = expect(rejects(bad, flipped, "checksum mismatch"), "bad checksum opened") && ok;
+    ok = expect(rejects(bad, edited(table, bytes), "corrupt section table"), "section past the end opened") && ok;
+    ok = expect(rejects(bad, edited(h, slots), "corrupt course data"), "hash table with no empty slot opened") && ok;
+    return expect(rejects(bad, edited(h, ids), "corrupt course data"), "prerequisite id out of range opened") && ok;
+}
+
+// A catalog saved and mapped back has the same codes, titles and
+// prerequisite and successor rows, finds every course and no other code,
+// and completes prefixes, searches titles and answers "is a required for
+// v" alike; damaged copies of the file do not open.
+static bool testSnapshot() {
+    Catalog catalog;
+    parseCourses(makeCatalogCSV(3000) + "ZZZZ100,Unknown prerequisite,NOPE999\n", catalog);
+    const std::string path = (std::filesystem::temp_directory_path() / "projecttwo-test.snap").string();
+    const std::string bad = (std::filesystem::temp_directory_path() / "projecttwo-test-bad.snap").string();
+    SnapshotView snap;
+    std::string error;
+    if (!expect(writeSnapshot(path, buildSnapshotData(catalog)) && snap.open(path, error), "round trip failed: " + error))
+        return false;
+
+    std::unordered_map<std::string, std::vector<std::string>> successors;
+    for (const Course& c : catalog)
+        for (CourseId p : c.prereqs())
+            if (catalog.hasCourse(p)) successors[std::string(catalog.code(p))].emplace_back(catalog.code(c.id()));
+
+    bool same = snap.size() == catalog.size() && snap.find("NOPE999") == SnapshotView::npos &&
+        snap.find("ZZZZ999") == SnapshotView::npos;
+    for (const Course& c : catalog) {
+        const std::string code(catalog.code(c.id()));
+        const uint32_t id = snap.find(code);
+        if (id == SnapshotView::npos || snap.code(id) != code || snap.title(id) != c.title()) {
+            same = false;
+            break;
+        }
+        std::vector<std::string_view> prereqs, expectedPrereqs;
+        std::vector<std::string> succ;
+        size_t known = 0;
+        for (uint32_t p : snap.prereqs(id)) prereqs.push_back(snap.code(p));
+        for (CourseId p : c.prereqs()) {
+            expectedPrereqs.push_back(catalog.code(p));
+            known += catalog.hasCourse(p);
+        }
+        for (uint32_t s : snap.successors(id)) succ.emplace_back(snap.code(s));
+        std::vector<std::string>& expected = successors[code];
+        std::sort(succ.begin(), succ.end());
+        std::sort(expected.begin(), expected.end());
+        same = same && prereqs == expectedPrereqs && succ == expected && snap.indegree(id) == known;
+    }
+
+    std::vector<CourseId> ids;
+    for (const Course& c : catalog) ids.push_back(c.id());
+    Xorshift rng(5);
+    bool answers = true;
+    for (int i = 0; i < 300; ++i) {
+        std::string_view code = catalog.code(ids[rng() % ids.size()]);
+        const std::string prefix(code.substr(0, 1 + rng() % code.size()));
+        std::vector<std::string_view> expected, got;
+        const size_t n = catalog.complete(prefix, kCompletions, [&](Course c) { expected.push_back(catalog.code(c.id())); });
+        answers = answers && snap.complete(prefix, kCompletions, [&](uint32_t id) { got.push_back(snap.code(id)); }) == n &&
+            got == expected;
+    }
+    for (int i = 0; i < 300; ++i) {
+        const std::string title(catalog.find(ids[rng() % ids.size()]).title());
+        const std::string query = i % 3 ? title : title.substr(0, title.find(' '));
+        std::vector<std::pair<std::string_view, double>> expected;
+        std::vector<TitleIndexView::Hit> hits;
+        const size_t n = catalog.searchTitles(query, kTitleResults,
+            [&](Course c, double score) { expected.emplace_back(catalog.code(c.id()), score); });
+        bool found = snap.searchTitles(query, kTitleResults, hits) == n && hits.size() == expected.size();
+        for (size_t h = 0; found && h < hits.size(); ++h)
+            found = snap.code(hits[h].doc) == expected[h].first && std::fabs(hits[h].score - expected[h].second) < 1e-9;
+        answers = answers && found;
+    }
+    PrereqSearch search(catalog.graph());
+    for (const auto& q : makeReachQueries(catalog.graph(), 4000))
+        if (q.first != q.second && catalog.hasCourse(q.first) && catalog.hasCourse(q.second))
+            answers = answers && snap.reaches(snap.find(catalog.code(q.first)), snap.find(catalog.code(q.second))) ==
+                search(q.first, q.second);
+    snap.close();
+    bool ok = expect(same, "snapshot differs from the catalog");
+    ok = expect(answers, "snapshot completions, title searches or reachability differ") && ok;
+    ok = testSnapshotDamage(path, bad) && ok;
+    std::filesystem::remove(path);
+    std::filesystem::remove(bad);
+    return ok;
+}
+
+// The CSR rows hold exactly the edges, each in both directions.
+static bool testGraph() {
+    const uint32_t nodes = 3000;
+    EdgeList edges = makeSyntheticDag(nodes, 42);
+    edges.emplace_back(5, 9);
+    edges.emplace_back(5, 9);
+    CsrGraph graph;
+    buildGraph(graph, nodes, edges);
+
+    std::vector<std::vector<CourseId>> succ(nodes), pred(nodes);
+    for (const auto& e : edges) {
+        succ[e.first].push_back(e.second);
+        pred[e.second].push_back(e.first);
+    }
+    bool ok = graph.nodeCount() == nodes;
+    for (CourseId u = 0; u < nodes && ok; ++u) {
+        std::vector<CourseId> s(graph.successors(u).begin(), graph.successors(u).end());
+        std::vector<CourseId> p(graph.predecessors(u).begin(), graph.predecessors(u).end());
+        std::sort(s.begin(), s.end());
+        std::sort(p.begin(), p.end());
+        std::sort(succ[u].begin(), succ[u].end());
+        std::sort(pred[u].begin(), pred[u].end());
+        ok = s == succ[u] && p == pred[u] && graph.outdegree(u) == s.size() && graph.indegree(u) == p.size();
+    }
+    return expect(ok, "graph rows differ from the edges");
+}
+
+// canonCode and every kernel keep the ASCII letters and digits of any
+// input, letters upper-cased, and drop everything else.
+static bool testCanon() {
+    Xorshift rng(5);
+    std::vector<std::string> inputs{ "", " csci-101 ", "\xEF\xBB\xBF" "math 2a", "Cs\t499\r\n" };
+    while (inputs.size() < 2000) {
+        std::string s;
+        for (size_t len = rng() % 120; s.size() < len;) s += (char)(rng() % 256);
+        inputs.push_back(s);
+    }
+
+    bool ok = true;
+    std::vector<char> out;
+    for (const std::string& s : inputs) {
+        std::string expected;
+        for (unsigned char ch : s) {
+            if (ch >= '0' && ch <= '9') expected += (char)ch;
+            else if ((ch | 0x20) >= 'a' && (ch | 0x20) <= 'z') expected += (char)(ch & ~0x20);
+        }
+        ok = ok && canonCode(s) == expected;
+        out.resize(s.size() + 64);
+        for (const auto& k : canon::kernels())
+            if (k.supported) ok = ok && std::string(out.data(), k.fn(s.data(), s.size(), out.data())) == expected;
+    }
+    return expect(ok, "canonical code differs");
+}
+
+// Code lookup, probing and then frozen: every interned code finds its id,
+// a repeat interns to the same id, and codes never interned are missing.
+static bool testHash() {
+    Xorshift rng(9);
+    std::unordered_map<std::string, CourseId> expected;
+    CodeInterner codes;
+    bool ok = true;
+    for (int i = 0; i < 20000; ++i) {
+        std::string code = makeCode(rng, 3000);
+        CourseId id = expected.emplace(code, (CourseId)expected.size()).first->second;
+        ok = ok && codes.intern(code) == id;
+    }
+    ok = expect(ok, "intern gave another id");
+
+    for (int frozen = 0; frozen < 2; ++frozen) {
+        bool found = true;
+        for (const auto& kv : expected)
+            found = found && codes.find(kv.first) == kv.second && codes.name(kv.second) == kv.first &&
+                codes.find(kv.first + "X") == kNoCourse;
+        ok = expect(found, frozen ? "frozen lookup differs" : "lookup differs") && ok;
+        if (!frozen) ok = expect(codes.freeze(), "freeze failed") && ok;
+    }
+    const CourseId added = codes.intern("ZZZZ100");
+    return expect(added == expected.size() && codes.find("ZZZZ100") == added, "intern after freeze differs") && ok;
+}
+
+// The order index lists courses in natural code order after a load and
+// after courses are added one by one.
+static bool testList() {
+    Catalog catalog;
+    parseCourses(makeCatalogCSV(3000), catalog);
+    Xorshift rng(13);
+    std::vector<CourseId> none;
+    for (int i = 0; i < 300; ++i)
+        catalog.put(catalog.intern(canonCode(makeCode(rng, 900))), "Added", { none.data(), none.data() });
+
+    std::vector<CourseId> expected, listed;
+    for (const Course& c : catalog) expected.push_back(c.id());
+    std::sort(expected.begin(), expected.end(),
+        [&](CourseId x, CourseId y) { return naturalLess(catalog.code(x), catalog.code(y)); });
+    CourseCursor cursor(catalog);
+    while (!cursor.done()) cursor.next(64, [&](Course c) { listed.push_back(c.id()); });
+    return expect(listed == expected, "course list out of code order");
+}
+
+// The radix sort orders codes as std::sort does, on one thread and on a
+// pool, and packed sort keys never contradict naturalLess.
+static bool testSort() {
+    Xorshift rng(17);
+    std::vector<std::string> codes;
+    for (int i = 0; i < 20000; ++i) codes.push_back(makeCode(rng, 5000));
+    auto key = [&](uint32_t i) { return std::string_view(codes[i]); };
+    std::vector<uint32_t> expected(codes.size());
+    for (uint32_t i = 0; i < codes.size(); ++i) expected[i] = i;
+    std::vector<uint32_t> serial = expected, parallel = expected;
+
+    std::sort(expected.begin(), expected.end(), [&](uint32_t p, uint32_t q) { return key(p) < key(q); });
+    radixSortByKey(serial, key);
+    ThreadPool pool(4);
+    radixSortByKey(parallel, key, &pool);
+    bool same = true;
+    for (size_t i = 0; i < expected.size(); ++i)
+        same = same && key(serial[i]) == key(expected[i]) && key(parallel[i]) == key(expected[i]);
+    bool ok = expect(same, "radix sort order differs from std::sort");
+
+    std::sort(expected.begin(), expected.end(), [&](uint32_t p, uint32_t q) { return naturalLess(key(p), key(q)); });
+    bool packed = true;
+    for (size_t i = 1; i < expected.size(); ++i)
+        packed = packed && codeSortKey(key(expected[i - 1])) <= codeSortKey(key(expected[i]));
+    return expect(packed, "packed sort keys disagree with naturalLess") && ok;
+}
+
+// Department, prefix, level and range queries find the same courses
+// through the order index as a scan of every course.
+static bool testRange() {
+    std::string csv;
+    for (size_t i = 0; i < 5000; ++i)
+        csv.append(kDepts[i % kDeptCount]).append(std::to_string(100 + i / kDeptCount * 7)).append(",Course\n");
+    Catalog catalog;
+    parseCourses(csv, catalog);
+
+    std::vector<std::string> texts{ "CS*", "M*", "math", "CSCI300-499", "BIOL200-CHEM300", "EE9XX", "WRIT800" };
+    for (size_t i = 0; i < 100; ++i) {
+        const std::string dept = kDepts[i * 7 % kDeptCount];
+        const size_t n = 100 + i * 37 % 700;
+        texts.push_back(dept + std::to_string(n / 100) + "XX");
+        texts.push_back(dept + std::to_string(n) + "-" + std::to_string(n + 40));
+    }
+
+    bool ok = true;
+    for (const std::string& text : texts) {
+        CodeQuery query;
+        std::string error;
+        if (!expect(query.parse(text, error), "query " + text + " rejected: " + error)) {
+            ok = false;
+            continue;
+        }
+        std::vector<CourseId> scanned, indexed;
+        for (size_t i = 0; i < catalog.size(); ++i)
+            if (query.matches(catalog.code(catalog.ordered(i).id()))) scanned.push_back(catalog.ordered(i).id());
+        auto range = query.candidates(catalog.size(), [&](size_t i) { return catalog.orderedKey(i); });
+        for (size_t i = range.first; i < range.second; ++i)
+            if (query.matches(catalog.code(catalog.ordered(i).id()))) indexed.push_back(catalog.ordered(i).id());
+        ok = expect(scanned == indexed, "query " + text + " results differ") && ok;
+    }
+    return ok;
+}
+
+// Completions are the first kCompletions codes with the prefix, shortest
+// first and in byte order within a length.
+static bool testComplete() {
+    CodeInterner codes;
+    Xorshift rng(3);
+    while (codes.size() < 5000) codes.intern(makeCode(rng, 3000));
+    auto codeAt = [&](uint32_t id) { return codes.name(id); };
+    std::vector<uint32_t> ids(codes.size());
+    for (uint32_t id = 0; id < ids.size(); ++id) ids[id] = id;
+    CodeCompleter completer;
+    completer.build(ids, codeAt);
+    CompletionView view = completer.view();
+
+    bool ok = true;
+    for (int i = 0; i < 500; ++i) {
+        std::string_view code = codes.name((uint32_t)(rng() % codes.size()));
+        std::string prefix = i % 50 == 0 ? "ZZ" : std::string(code.substr(0, 1 + rng() % code.size()));
+        std::vector<std::string_view> expected, got;
+        for (uint32_t id = 0; id < codes.size(); ++id)
+            if (codes.name(id).substr(0, prefix.size()) == prefix) expected.push_back(codes.name(id));
+        std::sort(expected.begin(), expected.end(), [](std::string_view a, std::string_view b) {
+            return a.size() != b.size() ? a.size() < b.size() : a < b;
+        });
+        expected.resize(std::min(expected.size(), kCompletions));
+        view.complete(prefix, kCompletions, codeAt, [&](uint32_t id) { got.push_back(codes.name(id)); });
+        ok = expect(got == expected, "completions of " + prefix + " differ") && ok;
+    }
+    return ok;
+}
+
+// Title search counts every title holding all the query's words and keeps
+// the best BM25 scores, best first, as scoring each title would.
+static bool testTitles() {
+    static const char* words[] = { "introduction", "to", "systems", "data", "structures", "advanced",
+        "calculus", "design", "analysis", "of", "and", "programming" };
+    const size_t wordCount = sizeof(words) / sizeof(words[0]);
+    Xorshift rng(11);
+    std::vector<std::string> titles(3000);
+    for (std::string& t : titles)
+        for (size_t k = 0, n = 1 + rng() % 5; k < n; ++k) t.append(k ? " " : "").append(words[rng() % wordCount]);
+    TitleIndex index;
+    index.build((uint32_t)titles.size(), [&](uint32_t d) { return std::string_view(titles[d]); });
+    TitleIndexView view = index.view();
+
+    std::vector<std::string> queries{ "Data Structures", "zzz", "systems zzz" };
+    while (queries.size() < 200) {
+        std::string q;
+        for (size_t k = 0, n = 1 + rng() % 3; k < n; ++k) q.append(k ? " " : "").append(words[rng() % wordCount]);
+        queries.push_back(q);
+    }
+
+    bool ok = true;
+    std::string scratch;
+    for (const std::string& q : queries) {
+        std::vector<std::string> terms, seen;
+        titles::forEachTerm(q, scratch, [&](std::string_view w) { terms.emplace_back(w); });
+        std::vector<TitleIndexView::Hit> expected;
+        for (uint32_t d = 0; d < titles.size(); ++d) {
+            seen.clear();
+            titles::forEachTerm(titles[d], scratch, [&](std::string_view w) { seen.emplace_back(w); });
+            double score = 0;
+            bool all = true;
+            for (size_t i = 0; all && i < terms.size(); ++i) {
+                if (std::find(terms.begin(), terms.begin() + i, terms[i]) != terms.begin() + i) continue;
+                uint32_t tf = (uint32_t)std::count(seen.begin(), seen.end(), terms[i]);
+                all = tf > 0;
+                if (all) score += view.bm25(view.idf(view.findTerm(terms[i])) * (titles::kK1 + 1.0), tf, d);
+            }
+            if (all) expected.push_back({ d, score });
+        }
+        const size_t found = expected.size();
+        std::sort(expected.begin(), expected.end(), [](const auto& x, const auto& y) {
+            return x.score != y.score ? x.score > y.score : x.doc < y.doc;
+        });
+        expected.resize(std::min(expected.size(), kTitleResults));
+
+        std::vector<TitleIndexView::Hit> got;
+        bool same = view.search(q, kTitleResults, [](uint32_t a, uint32_t b) { return a < b; }, got) == found &&
+            got.size() == expected.size();
+        for (size_t i = 0; same && i < got.size(); ++i)
+            same = got[i].doc == expected[i].doc && std::fabs(got[i].score - expected[i].score) < 1e-9;
+        ok = expect(same, "title search for '" + q + "' differs") && ok;
+    }
+    return ok;
+}
+
+// The BK-tree finds exactly the codes a scan finds within the radius, at
+// the same distances, and EditPattern agrees with the textbook distance.
+static bool testFuzzy() {
+    CodeInterner codes;
+    Xorshift rng(5);
+    while (codes.size() < 3000) codes.intern(makeCode(rng, 2000));
+    auto codeAt = [&](uint32_t id) { return codes.name(id); };
+    std::vector<uint32_t> ids(codes.size());
+    for (uint32_t id = 0; id < ids.size(); ++id) ids[id] = id;
+    FuzzyIndex index;
+    index.build(ids, codeAt);
+    FuzzyView view = index.view();
+
+    bool ok = true;
+    for (int i = 0; i < 200; ++i) {
+        std::string q(codes.name((uint32_t)(rng() % codes.size())));
+        for (size_t typos = rng() % 3; typos > 0; --typos) {
+            size_t at = rng() % (q.size() - 1);
+            switch (rng() % 4) {
+            case 0: std::swap(q[at], q[at + 1]); break;
+            case 1: q[at] = (char)('0' + rng() % 10); break;
+            case 2: q.erase(at, 1); break;
+            default: q.insert(at, 1, q[at]); break;
+            }
+        }
+        const uint32_t radius = fuzzyRadius(q);
+        EditPattern pattern(q);
+        std::vector<std::pair<uint32_t, uint32_t>> expected, got;
+        bool distances = true;
+        for (uint32_t id = 0; id < codes.size(); ++id) {
+            const uint32_t d = editDistance(q, codes.name(id));
+            distances = distances && pattern.distance(codes.name(id)) == d;
+            if (d <= radius) expected.emplace_back(id, d);
+        }
+        view.within(q, radius, [&](uint32_t id, uint32_t d) { got.emplace_back(id, d); });
+        std::sort(got.begin(), got.end());
+        ok = expect(distances, "EditPattern distance from " + q + " differs") && ok;
+        ok = expect(got == expected, "codes within " + std::to_string(radius) + " of " + q + " differ") && ok;
+    }
+    return ok;
+}
+
+// Direct and transitive unlocks list every course reachable from the
+// start once, at its shortest depth, as repeated passes over the edges
+// find them.
+static bool testUnlocks() {
+    const uint32_t nodes = 2000;
+    const EdgeList edges = makeCatalogDag(nodes, 5, 3, 7);
+    CsrGraph graph;
+    buildGraph(graph, nodes, edges);
+
+    bool ok = true;
+    Xorshift rng(11);
+    for (int i = 0; i < 40; ++i) {
+        const CourseId start = (CourseId)(rng() % nodes);
+        for (bool transitive : { false, true }) {
+            std::vector<uint32_t> depth(nodes, 0);
+            size_t count = 0;
+            for (uint32_t level = 1, added = 1; added > 0 && (transitive || level == 1); ++level) {
+                added = 0;
+                for (const auto& e : edges)
+                    if ((level == 1 ? e.first == start : depth[e.first] == level - 1) && e.second != start &&
+                        depth[e.second] == 0) {
+                        depth[e.second] = level;
+                        ++added;
+                    }
+                count += added;
+            }
+            auto got = collectUnlocks(start, nodes, transitive, [&](CourseId u) { return graph.successors(u); });
+            bool same = got.size() == count;
+            for (const auto& u : got) same = same && depth[u.first] == u.second;
+            ok = expect(same, "unlocks of " + std::to_string(start) + " differ") && ok;
+        }
+    }
+    return ok;
+}
+
+// Graphs for the reachability tests: catalog-shaped and random, each also
+// with a few random edges added, which close cycles.
+static std::vector<EdgeList> reachGraphs(uint32_t nodes) {
+    std::vector<EdgeList> graphs{ makeCatalogDag(nodes, 5, 3, 9), makeSyntheticDag(nodes, 9) };
+    Xorshift rng(21);
+    for (size_t g = 0; g < 2; ++g) {
+        graphs.push_back(graphs[g]);
+        for (int i = 0; i < 20; ++i) graphs.back().emplace_back((CourseId)(rng() % nodes), (CourseId)(rng() % nodes));
+    }
+    return graphs;
+}
+
+// The closure, dense and compressed, answers "is a required for v" as a
+// search back from v does.
+static bool testClosure() {
+    const uint32_t nodes = 1500;
+    bool ok = true;
+    for (const EdgeList& edges : reachGraphs(nodes)) {
+        CsrGraph graph;
+        buildGraph(graph, nodes, edges);
+        auto queries = makeReachQueries(graph, 4000);
+        PrereqSearch search(graph);
+        std::vector<bool> expected;
+        for (const auto& q : queries) expected.push_back(search(q.first, q.second));
+
+        bool dense = false;
+        for (size_t limit : { closure::kLimitBytes, (size_t)nodes * nodes / 8 / 2 }) {
+            TransitiveClosure tc;
+            if (!tc.build(nodes, [&](CourseId u) { return graph.successors(u); }, limit)) continue;
+            dense = dense || tc.dense();
+            bool same = true;
+            for (size_t i = 0; i < queries.size(); ++i)
+                same = same && (queries[i].first == queries[i].second || tc.reaches(queries[i].first, queries[i].second) == expected[i]);
+            ok = expect(same, tc.dense() ? "dense closure differs" : "compressed closure differs") && ok;
+        }
+        ok = expect(dense, "dense closure not built") && ok;
+    }
+    return ok;
+}
+
+// Reachability labels answer "is a required for v" as a search back from
+// v does.
+static bool testReach() {
+    const uint32_t nodes = 3000;
+    bool ok = true;
+    for (const EdgeList& edges : reachGraphs(nodes)) {
+        CsrGraph graph;
+        buildGraph(graph, nodes, edges);
+        auto queries = makeReachQueries(graph, 4000);
+        PrereqSearch search(graph);
+        ReachLabels labels;
+        labels.build(nodes, [&](CourseId u) { return graph.successors(u); });
+        const ReachView view = labels.view();
+        ReachScratch scratch;
+        bool same = true;
+        for (const auto& q : queries)
+            same = same && (q.first == q.second || view.reaches(q.first, q.second, scratch) == search(q.first, q.second));
+        ok = expect(same, "reachability labels differ") && ok;
+    }
+    return ok;
+}
+
+// The kept order stays topological through random prerequisite adds and
+// removals, and every add it rejects would really close a cycle.
+static bool testTopo() {
+    const uint32_t nodes = 2000;
+    EdgeList edges = makeCatalogDag(nodes, 5, 3, 13);
+    DynamicTopoOrder topo;
+    topo.build(nodes, [&](auto&& emit) { for (const auto& e : edges) emit(e.first, e.second); },
+        [](uint32_t u) { return u; });
+
+    // Whether v leads to u through the current edges.
+    std::vector<uint32_t> stamp(nodes, 0), stack;
+    uint32_t round = 0;
+    auto leadsTo = [&](uint32_t v, uint32_t u) {
+        ++round;
+        stack.assign(1, v);
+        while (!stack.empty()) {
+            const uint32_t x = stack.back();
+            stack.pop_back();
+            if (x == u) return true;
+            for (uint32_t y : topo.successors(x))
+                if (stamp[y] != round) {
+                    stamp[y] = round;
+                    stack.push_back(y);
+                }
+        }
+        return false;
+    };
+
+    Xorshift rng(29);
+    size_t rejected = 0;
+    bool ok = topo.size() == nodes, cycles = true;
+    for (int i = 0; i < 5000; ++i) {
+        if (rng() % 4 == 0) {
+            const auto& e = edges[rng() % edges.size()];
+            topo.removeEdge(e.first, e.second);
+            continue;
+        }
+        const uint32_t v = (uint32_t)(rng() % nodes);
+        const uint32_t u = rng() % 2 ? v - v % 200 + (uint32_t)(rng() % 200) : (uint32_t)(rng() % nodes);
+        const bool cycle = u == v || leadsTo(v, u);
+        if (topo.addEdge(u, v)) cycles = cycles && !cycle;
+        else {
+            ++rejected;
+            cycles = cycles && cycle;
+        }
+    }
+    for (uint32_t u = 0; u < nodes && ok; ++u)
+        for (uint32_t v : topo.successors(u)) ok = ok && topo.position(u) < topo.position(v);
+    ok = expect(ok, "kept order is not topological");
+    return expect(cycles && rejected > 0, "an edit was rejected or accepted wrongly") && ok;
+}
+
+// Through the catalog: after every edit the recommended order and the
+// prerequisite graph match those of a catalog loaded afresh with the same
+// courses, and every prerequisite the catalog rejects really closes a
+// cycle.
+static bool testEdits() {
+    const uint32_t courses = 600, edits = 3000;
+    Catalog catalog;
+    auto codeOf = [](uint32_t i) { return "C" + std::to_string(i); };
+    {
+        std::vector<std::vector<CourseId>> prereqs(courses);
+        for (uint32_t i = 0; i < courses; ++i) catalog.intern(codeOf(i));
+        for (const auto& e : makeCatalogDag(courses, 5, 3, 23)) prereqs[e.second].push_back(e.first);
+        for (uint32_t i = 0; i < courses; ++i)
+            catalog.put(i, "Course " + std::to_string(i), { prereqs[i].data(), prereqs[i].data() + prereqs[i].size() });
+        catalog.finishLoad();
+    }
+    auto reload = [&](Catalog& copy) {
+        std::vector<CourseId> prereqs;
+        for (const Course& c : catalog) {
+            prereqs.clear();
+            for (CourseId p : c.prereqs()) prereqs.push_back(copy.intern(catalog.code(p)));
+            copy.put(copy.intern(catalog.code(c.id())), c.title(), { prereqs.data(), prereqs.data() + prereqs.size() });
+        }
+        copy.finishLoad();
+    };
+    auto codes = [](const Catalog& c, const std::vector<CourseId>& ids) {
+        std::vector<std::string_view> out;
+        for (CourseId id : ids) out.push_back(c.code(id));
+        return out;
+    };
+    auto sortedCodes = [](const Catalog& c, IdSpan ids) {
+        std::vector<std::string_view> out;
+        for (CourseId id : ids) out.push_back(c.code(id));
+        std::sort(out.begin(), out.end());
+        return out;
+    };
+
+    Xorshift rng(31);
+    size_t mismatches = 0, rejected = 0;
+    for (uint32_t i = 0; i < edits; ++i) {
+        const CourseId a = catalog.intern(codeOf((uint32_t)(rng() % (courses + 20))));
+        const CourseId b = catalog.intern(codeOf((uint32_t)(rng() % (courses + 20))));
+        switch (rng() % 8) {
+        case 0: catalog.addCourse(a, "Added"); break;
+        case 1: catalog.removeCourse(a); break;
+        case 2: case 3: if (catalog.hasCourse(b)) catalog.removePrereq(b, a); break;
+        default:
+            if (!catalog.hasCourse(b) || a == b) break;
+            if (!catalog.addPrereq(b, a)) {
+                // b must already be required by a.
+                ++rejected;
+                std::vector<CourseId> stack{ b };
+                std::vector<bool> seen(catalog.idCount(), false);
+                bool cycle = false;
+                while (!stack.empty() && !cycle) {
+                    const CourseId u = stack.back();
+                    stack.pop_back();
+                    for (CourseId v : catalog.graph().successors(u)) {
+                        cycle = cycle || v == a;
+                        if (!seen[v]) {
+                            seen[v] = true;
+                            stack.push_back(v);
+                        }
+                    }
+                }
+                mismatches += !cycle;
+            }
+        }
+        Catalog copy;
+        reload(copy);
+        bool same = codes(catalog, recommendedOrder(catalog)) == codes(copy, recommendedOrder(copy));
+        for (const Course& c : catalog) {
+            const CourseId id = copy.idOf(catalog.code(c.id()));
+            same = same && sortedCodes(catalog, catalog.graph().successors(c.id())) ==
+                sortedCodes(copy, copy.graph().successors(id)) &&
+                sortedCodes(catalog, catalog.graph().predecessors(c.id())) ==
+                sortedCodes(copy, copy.graph().predecessors(id));
+        }
+        mismatches += !same;
+    }
+    return expect(mismatches == 0 && rejected > 0, std::to_string(mismatches) + " of " + std::to_string(edits) +
+        " edits left an order or a graph unlike a fresh load's");
+}
+
+// Straight on the structures: through random edits (edges and nodes added
+// and removed, now and then an edge against the levels that may close a
+// cycle) the patched graph keeps the rows of a fresh build, and the
+// repaired order is a fresh Kahn sort's, or reported gone when there is a
+// cycle. The edit that closed one is undone and the order rebuilt.
+static bool testRanked() {
+    const uint32_t nodes = 800, edits = 4000;
+    Xorshift rng(37);
+    std::vector<uint32_t> level(nodes), rank(nodes);
+    for (uint32_t u = 0; u < nodes; ++u) level[u] = rank[u] = u;
+    for (uint32_t u = nodes - 1; u > 0; --u) {
+        std::swap(level[u], level[rng() % (u + 1)]);
+        std::swap(rank[u], rank[rng() % (u + 1)]);
+    }
+    std::vector<bool> present(nodes);
+    for (uint32_t u = 0; u < nodes; ++u) present[u] = rng() % 8 != 0;
+    auto randomPresent = [&]() {
+        uint32_t u;
+        do u = (uint32_t)(rng() % nodes); while (!present[u]);
+        return u;
+    };
+    // Two present nodes, the lower level first unless backward.
+    auto randomEdge = [&](bool backward) {
+        uint32_t u = randomPresent(), v;
+        do v = randomPresent(); while (v == u);
+        if ((level[u] > level[v]) != backward) std::swap(u, v);
+        return std::make_pair(u, v);
+    };
+
+    EdgeList edges;
+    for (uint32_t i = 0; i < nodes * 2; ++i) edges.push_back(randomEdge(false));
+    CsrGraph graph, fresh;
+    buildGraph(graph, nodes, edges);
+    auto ready = [&](uint32_t u) { return (bool)present[u]; };
+    auto successors = [&](uint32_t u) { return graph.successors(u); };
+    auto predecessors = [&](uint32_t u) { return graph.predecessors(u); };
+    RankedTopoOrder ranked;
+    auto rebuild = [&]() {
+        return ranked.build(nodes, ready, [&](uint32_t u) { return graph.indegree(u); }, successors,
+            [&](uint32_t u) { return rank[u]; });
+    };
+    auto sameRow = [](IdSpan a, IdSpan b) {
+        std::vector<uint32_t> x(a.begin(), a.end()), y(b.begin(), b.end());
+        std::sort(x.begin(), x.end());
+        std::sort(y.begin(), y.end());
+        return x == y;
+    };
+    bool ok = expect(rebuild(), "the first build found a cycle");
+
+    size_t orders = 0, rows = 0, cycles = 0, missed = 0, windows = 0, lengths = 0;
+    std::vector<uint32_t> touched, expected, remaining(nodes);
+    EdgeList added;
+    DaryHeap<4> frontier;
+    for (uint32_t i = 0; i < edits; ++i) {
+        touched.clear();
+        added.clear();
+        const uint32_t op = (uint32_t)(rng() % 16);
+        if (op < 6) {
+            added.push_back(randomEdge(op == 0));
+        }
+        else if (op < 11 && !edges.empty()) {
+            const size_t k = rng() % edges.size();
+            graph.removeEdge(edges[k].first, edges[k].second);
+            touched.push_back(edges[k].second);
+            edges[k] = edges.back();
+            edges.pop_back();
+        }
+        else if (op < 15) {
+            const uint32_t u = (uint32_t)(rng() % nodes);
+            if (present[u]) continue;
+            present[u] = true;
+            touched.push_back(u);
+            for (uint32_t j = 0, k = (uint32_t)(rng() % 3); j < k; ++j) {
+                const uint32_t v = randomPresent();
+                if (v != u && level[u] < level[v]) added.emplace_back(u, v);
+            }
+        }
+        else {
+            const uint32_t u = randomPresent();
+            present[u] = false;
+            touched.push_back(u);
+            for (size_t k = 0; k < edges.size();) {
+                const auto e = edges[k];
+                if (e.first != u && e.second != u) {
+                    ++k;
+                    continue;
+                }
+                graph.removeEdge(e.first, e.second);
+                touched.push_back(e.second);
+                edges[k] = edges.back();
+                edges.pop_back();
+            }
+        }
+        for (const auto& e : added) {
+            graph.addEdge(e.first, e.second);
+            edges.push_back(e);
+            touched.push_back(e.second);
+        }
+
+        buildGraph(fresh, nodes, edges);
+        for (uint32_t u = 0; u < nodes; ++u) {
+            remaining[u] = fresh.indegree(u);
+            rows += !sameRow(graph.successors(u), fresh.successors(u)) ||
+                !sameRow(graph.predecessors(u), fresh.predecessors(u));
+        }
+        expected.clear();
+        const bool cycle = kahnSort(frontier, nodes, ready, remaining, [&](uint32_t u) { return fresh.successors(u); },
+            [&](uint32_t u) { return (uint64_t)rank[u]; }, expected) != (size_t)std::count(present.begin(), present.end(), true);
+        if (ranked.repair(nodes, touched, ready, predecessors, successors,
+                [&](uint32_t a, uint32_t b) { return rank[a] < rank[b]; })) {
+            missed += cycle;
+            orders += ranked.order() != expected;
+            windows += ranked.lastWindow();
+            lengths += expected.size();
+            continue;
+        }
+        missed += !cycle;
+        ++cycles;
+        for (const auto& e : added) {
+            graph.removeEdge(e.first, e.second);
+            edges.erase(std::find(edges.begin(), edges.end(), e));
+        }
+        ok = expect(rebuild(), "a cycle outlived undoing its edit") && ok;
+    }
+    ok = expect(rows == 0, std::to_string(rows) + " patched rows differ from a fresh build") && ok;
+    ok = expect(missed == 0 && cycles > 0, std::to_string(missed) + " cycles missed or made up") && ok;
+    ok = expect(windows * 2 < lengths, "repairs rewrote " + std::to_string(windows) + " of " +
+        std::to_string(lengths) + " positions") && ok;
+    return expect(orders == 0, std::to_string(orders) + " repaired orders differ from a fresh sort") && ok;
+}
+
+// A course's level is its longest prerequisite chain, and the sorted
+// levels come out the same on one thread and on a pool (big enough that
+// the first levels are split across it).
+static bool testLevels() {
+    const uint32_t nodes = 40000;
+    bool ok = true;
+    for (const DagShape& shape : { DagShape{ "catalog", 10, 3 }, DagShape{ "random", 0, 0 } }) {
+        const EdgeList edges = makeDag(nodes, shape, 17);
+        CsrGraph graph;
+        buildGraph(graph, nodes, edges);
+        auto indegreeOf = [&](CourseId v) { return graph.indegree(v); };
+        auto successors = [&](CourseId u) { return graph.successors(u); };
+
+        std::vector<uint32_t> indegree(nodes), order;
+        for (CourseId v = 0; v < nodes; ++v) indegree[v] = graph.indegree(v);
+        FifoFrontier fifo;
+        kahnSort(fifo, nodes, [](CourseId) { return true; }, indegree, successors, [](CourseId) { return 0ull; }, order);
+        std::vector<uint32_t> expected(nodes, 0);
+        for (CourseId u : order)
+            for (CourseId v : graph.successors(u)) expected[v] = std::max(expected[v], expected[u] + 1);
+
+        LevelOrder serial, parallel;
+        ThreadPool pool(4);
+        bool done = serial.build(nodes, indegreeOf, successors) && parallel.build(nodes, indegreeOf, successors, &pool);
+        serial.sortLevels([](CourseId u) { return u; });
+        parallel.sortLevels([](CourseId u) { return u; }, &pool);
+        for (CourseId v = 0; v < nodes && done; ++v) done = serial.level(v) == expected[v];
+        ok = expect(done, std::string(shape.name) + ": levels are not the longest chains") && ok;
+        ok = expect(isTopological(serial.order(), nodes, edges) && serial.order() == parallel.order() &&
+            serial.levelStart() == parallel.levelStart(), std::string(shape.name) + ": level order differs on the pool") && ok;
+    }
+    return ok;
+}
+
+// Every frontier gives a topological order; the heaps take the smallest
+// key first exactly as an ordered set does, the bucket queue matches the
+// sorted levels, and a cycle stops them all short.
+static bool testFrontier() {
+    const uint32_t nodes = 5000;
+    bool ok = true;
+    for (const DagShape& shape : { DagShape{ "catalog", 5, 3 }, DagShape{ "random", 0, 0 } }) {
+        const EdgeList edges = makeDag(nodes, shape, 19);
+        CsrGraph graph;
+        buildGraph(graph, nodes, edges);
+        auto all = [](CourseId) { return true; };
+        auto successors = [&](CourseId u) { return graph.successors(u); };
+        std::vector<uint32_t> indegree(nodes), remaining, order;
+        for (CourseId v = 0; v < nodes; ++v) indegree[v] = graph.indegree(v);
+        LevelOrder levels;
+        levels.build(nodes, [&](CourseId v) { return indegree[v]; }, successors);
+        levels.sortLevels([](CourseId u) { return u; });
+
+        // Smallest key first from an ordered set of (key, node).
+        auto reference = [&](auto&& key) {
+            std::vector<uint32_t> out;
+            remaining = indegree;
+            std::set<std::pair<uint64_t, CourseId>> ready;
+            for (CourseId v = 0; v < nodes; ++v)
+                if (remaining[v] == 0) ready.insert({ key(v), v });
+            while (!ready.empty()) {
+                const CourseId u = ready.begin()->second;
+                ready.erase(ready.begin());
+                out.push_back(u);
+                for (CourseId v : graph.successors(u))
+                    if (--remaining[v] == 0) ready.insert({ key(v), v });
+            }
+            return out;
+        };
+        auto byCode = [](CourseId u) { return (uint64_t)u; };
+        auto byUnlocks = [&](CourseId u) { return (uint64_t)(UINT32_MAX - graph.outdegree(u)) << 32 | u; };
+        auto byLevel = [&](CourseId u) { return (uint64_t)levels.level(u) << 32 | u; };
+        auto run = [&](auto&& frontier, auto&& key) {
+            remaining = indegree;
+            order.clear();
+            kahnSort(frontier, nodes, all, remaining, successors, key, order);
+            return order;
+        };
+
+        const std::string name = shape.name;
+        const std::vector<uint32_t> codeOrder = reference(byCode);
+        ok = expect(isTopological(codeOrder, nodes, edges), name + ": reference order is not topological") && ok;
+        ok = expect(isTopological(run(FifoFrontier(), byCode), nodes, edges), name + ": FIFO order is not topological") && ok;
+        ok = expect(run(DaryHeap<2>(), byCode) == codeOrder, name + ": 2-ary heap order differs") && ok;
+        ok = expect(run(DaryHeap<4>(), byCode) == codeOrder, name + ": 4-ary heap order differs") && ok;
+        ok = expect(run(DaryHeap<8>(), byCode) == codeOrder, name + ": 8-ary heap order differs") && ok;
+        ok = expect(run(DaryHeap<4>(), byUnlocks) == reference(byUnlocks), name + ": unlocks order differs") && ok;
+        ok = expect(run(BucketQueue(), byLevel) == levels.order(), name + ": bucket queue differs from the levels") && ok;
+
+        // Turn one prerequisite around: the pair, and what follows them, stay out.
+        EdgeList cyclic = edges;
+        cyclic.emplace_back(edges.back().second, edges.back().first);
+        CsrGraph cycleGraph;
+        buildGraph(cycleGraph, nodes, cyclic);
+        for (CourseId v = 0; v < nodes; ++v) remaining[v] = cycleGraph.indegree(v);
+        order.clear();
+        DaryHeap<4> heap;
+        ok = expect(kahnSort(heap, nodes, all, remaining, [&](CourseId u) { return cycleGraph.successors(u); },
+            byCode, order) < nodes, name + ": a cycle did not stop the sort") && ok;
+    }
+    return ok;
+}
+
+bool runTests(const std::string& name) {
+    static const std::pair<const char*, bool (*)()> tests[] = { { "parallel", testParallel },
+        { "splitcsv", testSplitCSV }, { "encoding", testEncoding }, { "snapshot", testSnapshot },
+        { "graph", testGraph }, { "canon", testCanon }, { "hash", testHash }, { "list", testList },
+        { "sort", testSort }, { "range", testRange }, { "complete", testComplete }, { "titles", testTitles },
+        { "fuzzy", testFuzzy }, { "unlocks", testUnlocks }, { "closure", testClosure }, { "reach", testReach },
+        { "topo", testTopo }, { "edits", testEdits }, { "ranked", testRanked }, { "levels", testLevels },
+        { "frontier", testFrontier } };
+    size_t run = 0, failed = 0;
+    for (const auto& test : tests) {
+        if (name != "all" && name != test.first) continue;
+        ++run;
+        bool ok = test.second();
+        failed += !ok;
+        std::cout << test.first << ": " << (ok ? "ok" : "FAILED") << "\n";
+    }
+    if (run == 0) {
+        std::cout << "Unknown test '" << name << "'. Available: all";
+        for (const auto& test : tests) std::cout << ", " << test.first;
+        std::cout << "\n";
+        return false;
+    }
+    if (run > 1) std::cout << (run - failed) << " of " << run << " tests passed.\n";
+    return failed == 0;
+}
@@ -0,0 +1,253 @@
+﻿// TextEncoding.h
+// CS499 – Final ePortfolio Artifact (Advising Assistance Program)
+//
+// Description:
+// Input encoding detection and a streaming UTF-16 -> UTF-8 transcoder.
+// Registrar exports arrive as UTF-16 (with or without a BOM, either byte
+// order); the CSV parser only understands UTF-8, so UTF-16 input is
+// transcoded in front of it. Runs of ASCII, which is nearly all of a
+// course catalog, are narrowed 16 or 32 code units at a time with SSE2 or
+// AVX2; everything else goes through the scalar path. Invalid or unpaired
+// surrogates become U+FFFD.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Simd.h"
+
+enum class TextEncoding { Utf8, Utf16LE, Utf16BE };
+
+struct EncodingInfo {
+    TextEncoding encoding = TextEncoding::Utf8;
+    size_t bomBytes = 0;
+};
+
+static inline const char* encodingName(TextEncoding e) {
+    switch (e) {
+    case TextEncoding::Utf16LE: return "UTF-16LE";
+    case TextEncoding::Utf16BE: return "UTF-16BE";
+    default: return "UTF-8";
+    }
+}
+
+// Looks for a BOM first. Without one, text that has NUL in nearly every
+// other byte of the first 512 bytes is taken to be UTF-16 (CSV exports
+// are mostly ASCII, which makes this a reliable signal).
+static inline EncodingInfo detectEncoding(std::string_view data) {
+    const unsigned char* p = (const unsigned char*)data.data();
+    size_t n = data.size();
+    if (n >= 3 && p[0] == 0xEF && p[1] == 0xBB && p[2] == 0xBF) return { TextEncoding::Utf8, 3 };
+    if (n >= 2 && p[0] == 0xFF && p[1] == 0xFE) return { TextEncoding::Utf16LE, 2 };
+    if (n >= 2 && p[0] == 0xFE && p[1] == 0xFF) return { TextEncoding::Utf16BE, 2 };
+
+    size_t sample = std::min<size_t>(n, 512) & ~(size_t)1;
+    if (sample < 4) return {};
+    size_t evenZero = 0, oddZero = 0;
+    for (size_t i = 0; i < sample; i += 2) {
+        evenZero += p[i] == 0;
+        oddZero += p[i + 1] == 0;
+    }
+    size_t units = sample / 2;
+    if (oddZero * 10 >= units * 9 && evenZero * 10 < units) return { TextEncoding::Utf16LE, 0 };
+    if (evenZero * 10 >= units * 9 && oddZero * 10 < units) return { TextEncoding::Utf16BE, 0 };
+    return {};
+}
+
+namespace utf16 {
+
+// Narrows whole blocks of ASCII code units; stops at the first block that
+// holds a non-ASCII unit. Returns the number of units written to out.
+using AsciiKernel = size_t (*)(const unsigned char* p, size_t units, bool bigEndian, char* out);
+
+static inline size_t asciiScalar(const unsigned char* p, size_t units, bool bigEndian, char* out) {
+    size_t i = 0;
+    for (; i + 8 <= units; i += 8) {
+        uint16_t any = 0;
+        for (size_t k = 0; k < 8; ++k) {
+            const unsigned char* u = p + 2 * (i + k);
+            any |= (uint16_t)(bigEndian ? (u[0] << 8 | u[1]) : (u[1] << 8 | u[0]));
+        }
+        if (any >= 0x80) break;
+        for (size_t k = 0; k < 8; ++k) out[i + k] = (char)p[2 * (i + k) + (bigEndian ? 1 : 0)];
+    }
+    return i;
+}
+
+#if PT_X86
+static size_t asciiSse2(const unsigned char* p, size_t units, bool bigEndian, char* out) {
+    const __m128i high = _mm_set1_epi16((short)0xFF80);
+    size_t i = 0;
+    for (; i + 16 <= units; i += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(p + 2 * i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(p + 2 * i + 16));
+        if (bigEndian) {
+            a = _mm_or_si128(_mm_slli_epi16(a, 8), _mm_srli_epi16(a, 8));
+            b = _mm_or_si128(_mm_slli_epi16(b, 8), _mm_srli_epi16(b, 8));
+        }
+        __m128i bits = _mm_and_si128(_mm_or_si128(a, b), high);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(bits, _mm_setzero_si128())) != 0xFFFF) break;
+        _mm_storeu_si128((__m128i*)(out + i), _mm_packus_epi16(a, b));
+    }
+    return i;
+}
+
+PT_TARGET("avx2")
+static size_t asciiAvx2(const unsigned char* p, size_t units, bool bigEndian, char* out) {
+    const __m256i high = _mm256_set1_epi16((short)0xFF80);
+    const __m256i swap = _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+        1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    size_t i = 0;
+    for (; i + 32 <= units; i += 32) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(p + 2 * i));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(p + 2 * i + 32));
+        if (bigEndian) {
+            a = _mm256_shuffle_epi8(a, swap);
+            b = _mm256_shuffle_epi8(b, swap);
+        }
+        if (!_mm256_testz_si256(_mm256_or_si256(a, b), high)) break;
+        // packus works per 128-bit lane; restore the unit order afterwards.
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+        _mm256_storeu_si256((__m256i*)(out + i), packed);
+    }
+    return i;
+}
+#endif
+
+struct AsciiKernelInfo {
+    const char* name;
+    AsciiKernel fn;
+    bool supported;
+};
+
+// All kernels compiled into this build, fastest first.
+static inline std::vector<AsciiKernelInfo> asciiKernels() {
+    std::vector<AsciiKernelInfo> ks;
+#if PT_X86
+    ks.push_back({ "avx2", asciiAvx2, CpuFeatures::get().avx2 });
+    ks.push_back({ "sse2", asciiSse2, true });
+#endif
+    ks.push_back({ "scalar", asciiScalar, true });
+    return ks;
+}
+
+static inline AsciiKernel activeAsciiKernel() {
+#if PT_X86
+    return CpuFeatures::get().avx2 ? asciiAvx2 : asciiSse2;
+#else
+    return asciiScalar;
+#endif
+}
+
+static inline char* putUtf8(uint32_t cp, char* out) {
+    if (cp < 0x80) {
+        *out++ = (char)cp;
+    }
+    else if (cp < 0x800) {
+        *out++ = (char)(0xC0 | (cp >> 6));
+        *out++ = (char)(0x80 | (cp & 0x3F));
+    }
+    else if (cp < 0x10000) {
+        *out++ = (char)(0xE0 | (cp >> 12));
+        *out++ = (char)(0x80 | ((cp >> 6) & 0x3F));
+        *out++ = (char)(0x80 | (cp & 0x3F));
+    }
+    else {
+        *out++ = (char)(0xF0 | (cp >> 18));
+        *out++ = (char)(0x80 | ((cp >> 12) & 0x3F));
+        *out++ = (char)(0x80 | ((cp >> 6) & 0x3F));
+        *out++ = (char)(0x80 | (cp & 0x3F));
+    }
+    return out;
+}
+
+} // namespace utf16
+
+// Streaming decoder: feed() may be called with arbitrary slices of the
+// input (odd lengths and split surrogate pairs are carried over), and
+// finish() flushes whatever is left dangling at the end.
+class Utf16ToUtf8 {
+private:
+    bool bigEndian_;
+    utf16::AsciiKernel ascii_;
+    int pendingByte_ = -1;      // odd trailing byte of the previous slice
+    uint16_t highSurrogate_ = 0;
+
+    char* unit(uint16_t u, char* out) {
+        if (highSurrogate_) {
+            if (u >= 0xDC00 && u <= 0xDFFF) {
+                uint32_t cp = 0x10000 + (((uint32_t)highSurrogate_ - 0xD800) << 10) + (u - 0xDC00);
+                highSurrogate_ = 0;
+                return utf16::putUtf8(cp, out);
+            }
+            highSurrogate_ = 0;
+            out = utf16::putUtf8(0xFFFD, out);
+        }
+        if (u >= 0xD800 && u <= 0xDBFF) highSurrogate_ = u;
+        else if (u >= 0xDC00 && u <= 0xDFFF) out = utf16::putUtf8(0xFFFD, out);
+        else out = utf16::putUtf8(u, out);
+        return out;
+    }
+
+    uint16_t load(const unsigned char* p) const {
+        return bigEndian_ ? (uint16_t)(p[0] << 8 | p[1]) : (uint16_t)(p[1] << 8 | p[0]);
+    }
+
+public:
+    explicit Utf16ToUtf8(bool bigEndian, utf16::AsciiKernel ascii = utf16::activeAsciiKernel())
+        : bigEndian_(bigEndian), ascii_(ascii) {}
+
+    void feed(const char* data, size_t n, std::string& out) {
+        const unsigned char* p = (const unsigned char*)data;
+        size_t base = out.size();
+        out.resize(base + (n / 2 + 2) * 3);
+        char* dst = &out[base];
+
+        if (pendingByte_ >= 0 && n > 0) {
+            unsigned char pair[2] = { (unsigned char)pendingByte_, p[0] };
+            dst = unit(load(pair), dst);
+            pendingByte_ = -1;
+            ++p;
+            --n;
+        }
+
+        size_t units = n / 2, i = 0;
+        while (i < units) {
+            if (!highSurrogate_) {
+                size_t k = ascii_(p + 2 * i, units - i, bigEndian_, dst);
+                i += k;
+                dst += k;
+                if (i >= units) break;
+            }
+            for (size_t stop = std::min(units, i + 16); i < stop; ++i) dst = unit(load(p + 2 * i), dst);
+        }
+        if (n & 1) pendingByte_ = p[n - 1];
+
+        out.resize((size_t)(dst - out.data()));
+    }
+
+    void finish(std::string& out) {
+        if (highSurrogate_ || pendingByte_ >= 0) {
+            char buf[4];
+            out.append(buf, utf16::putUtf8(0xFFFD, buf));
+        }
+        highSurrogate_ = 0;
+        pendingByte_ = -1;
+    }
+};
+
+// Transcodes a whole UTF-16 buffer (without its BOM) block by block.
+static inline void transcodeUtf16(std::string_view in, bool bigEndian, std::string& out) {
+    const size_t block = 1 << 20;
+    Utf16ToUtf8 dec(bigEndian);
+    out.clear();
+    out.reserve(in.size() / 2 + 16);
+    for (size_t pos = 0; pos < in.size(); pos += block)
+        dec.feed(in.data() + pos, std::min(block, in.size() - pos), out);
+    dec.finish(out);
+}
@@ -0,0 +1,108 @@
+﻿// ThreadPool.h
+// CS499 – Final ePortfolio Artifact (Advising Assistance Program)
+//
+// Description:
+// Small fixed-size thread pool used by the bulk operations (CSV ingest,
+// sorting, graph passes). Work is submitted as an index range with
+// parallelFor; the calling thread takes part in the work and the call
+// returns once every index has been processed.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+private:
+    std::vector<std::thread> workers_;
+    std::mutex mu_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    std::function<void()> job_;
+    uint64_t generation_ = 0;
+    size_t busy_ = 0;
+    bool stop_ = false;
+    std::mutex runMu_;
+
+    void workerLoop() {
+        uint64_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lk(mu_);
+                wake_.wait(lk, [&] { return stop_ || generation_ != seen; });
+                if (stop_) return;
+                seen = generation_;
+            }
+            job_();
+            {
+                std::lock_guard<std::mutex> lk(mu_);
+                if (--busy_ == 0) done_.notify_all();
+            }
+        }
+    }
+
+public:
+    // Creates threads - 1 workers; the caller of parallelFor is the last one.
+    explicit ThreadPool(unsigned threads = std::thread::hardware_concurrency()) {
+        if (threads == 0) threads = 1;
+        for (unsigned i = 1; i < threads; ++i)
+            workers_.emplace_back([this] { workerLoop(); });
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto& t : workers_) t.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Number of threads that run a parallelFor, including the caller.
+    unsigned size() const { return (unsigned)workers_.size() + 1; }
+
+    // Calls fn(i) for every i in [0, count) and waits for all of them.
+    // Indices are handed out dynamically, so uneven chunks balance out.
+    // Not reentrant: fn must not call parallelFor on the same pool.
+    template <class Fn>
+    void parallelFor(size_t count, Fn&& fn) {
+        if (count == 0) return;
+        if (workers_.empty() || count == 1) {
+            for (size_t i = 0; i < count; ++i) fn(i);
+            return;
+        }
+
+        std::lock_guard<std::mutex> run(runMu_);
+        std::atomic<size_t> next{ 0 };
+        auto body = [&] {
+            for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < count;) fn(i);
+        };
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            job_ = body;
+            busy_ = workers_.size();
+            ++generation_;
+        }
+        wake_.notify_all();
+        body();
+
+        std::unique_lock<std::mutex> lk(mu_);
+        done_.wait(lk, [&] { return busy_ == 0; });
+        job_ = nullptr;
+    }
+
+    // Process-wide pool sized to the machine.
+    static ThreadPool& shared() {
+        static ThreadPool pool;
+        return pool;
+    }
+};
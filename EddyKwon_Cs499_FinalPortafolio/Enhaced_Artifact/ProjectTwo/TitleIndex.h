@@ -0,0 +1,397 @@
+﻿// TitleIndex.h
+// CS499 – Final ePortfolio Artifact (Advising Assistance Program)
+//
+// Description:
+// Inverted index over course titles for full-text search. Titles are cut
+// into terms (runs of ASCII letters and digits, lower-cased; bytes >= 0x80
+// are kept so accented words stay whole). Each term has a posting list of
+// the documents (course ids) that contain it, in id order.
+//
+// Posting lists are compressed: blocks of up to 128 postings, each
+// posting one varint of (gap to the previous id) << 1 | (tf > 1), plus a
+// varint tf when it is above one. Per block the index keeps the last id and
+// the byte offset, so a list can be skipped through without decoding it.
+//
+// A query is an AND of its terms. The shortest list drives; every other
+// list is probed with a galloping cursor (exponential search over block
+// last-ids, then a search inside the one decoded block), so the cost tracks
+// the shortest list rather than the longest. Matches are scored with BM25
+// (k1 = 1.2, b = 0.75) using per-document title lengths, keeping the best
+// k in a bounded heap rather than sorting every match.
+//
+// TitleIndexView evaluates over borrowed arrays (a TitleIndex's own
+// vectors or sections of a mapped snapshot), like PerfectHashView.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Interner.h"
+#include "RadixSort.h"
+
+namespace titles {
+
+// map[c] is the term byte for c, or 0 when c separates terms.
+struct TermTable {
+    unsigned char map[256];
+};
+
+constexpr TermTable makeTermTable() {
+    TermTable t{};
+    for (int c = 0; c < 256; ++c) {
+        if (c >= '0' && c <= '9') t.map[c] = (unsigned char)c;
+        else if (c >= 'a' && c <= 'z') t.map[c] = (unsigned char)c;
+        else if (c >= 'A' && c <= 'Z') t.map[c] = (unsigned char)(c - 'A' + 'a');
+        else if (c >= 0x80) t.map[c] = (unsigned char)c;
+    }
+    return t;
+}
+
+static constexpr TermTable kTermTable = makeTermTable();
+
+// Calls fn(term) for each term of text; term points into scratch.
+template <class Fn>
+static void forEachTerm(std::string_view text, std::string& scratch, Fn&& fn) {
+    size_t i = 0;
+    while (i < text.size()) {
+        while (i < text.size() && !kTermTable.map[(unsigned char)text[i]]) ++i;
+        scratch.clear();
+        for (; i < text.size() && kTermTable.map[(unsigned char)text[i]]; ++i)
+            scratch.push_back((char)kTermTable.map[(unsigned char)text[i]]);
+        if (!scratch.empty()) fn(std::string_view(scratch));
+    }
+}
+
+static inline void putVarint(std::vector<uint8_t>& out, uint32_t v) {
+    while (v >= 0x80) {
+        out.push_back((uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((uint8_t)v);
+}
+
+// Reads one varint from [p, end); returns false when it runs off the end.
+static inline bool getVarint(const uint8_t*& p, const uint8_t* end, uint32_t& v) {
+    v = 0;
+    for (unsigned shift = 0; p < end && shift < 35; shift += 7) {
+        uint8_t b = *p++;
+        v |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+static const uint32_t kBlockSize = 128;
+static const uint32_t kEnd = UINT32_MAX;
+
+// BM25 parameters.
+static const double kK1 = 1.2;
+static const double kB = 0.75;
+
+} // namespace titles
+
+struct TitleIndexView {
+    const uint32_t* termOffsets = nullptr;  // terms + 1, into termBytes
+    const char* termBytes = nullptr;        // vocabulary in byte order
+    const uint32_t* termBlocks = nullptr;   // terms + 1, into blocks
+    const uint32_t* termDocs = nullptr;     // terms: list lengths
+    const uint32_t* blockLast = nullptr;    // blocks: last id in the block
+    const uint32_t* blockOffset = nullptr;  // blocks + 1, into postings
+    const uint8_t* postings = nullptr;
+    const uint16_t* docLength = nullptr;    // docs: terms in each title
+    uint32_t terms = 0;
+    uint32_t docs = 0;                      // id space: ids are < docs
+    uint32_t indexedDocs = 0;               // ids with a non-empty title
+    double avgLength = 0;
+
+    struct Hit {
+        uint32_t doc;
+        double score;
+    };
+
+    bool empty() const { return terms == 0; }
+
+    std::string_view term(uint32_t t) const {
+        return std::string_view(termBytes + termOffsets[t], termOffsets[t + 1] - termOffsets[t]);
+    }
+
+    // Term id of a (normalized) term, or titles::kEnd.
+    uint32_t findTerm(std::string_view s) const {
+        uint32_t lo = 0, hi = terms;
+        while (lo < hi) {
+            uint32_t mid = lo + (hi - lo) / 2;
+            if (term(mid) < s) lo = mid + 1;
+            else hi = mid;
+        }
+        return lo < terms && term(lo) == s ? lo : titles::kEnd;
+    }
+
+    // Walks one posting list; advance() gallops over block last-ids and
+    // decodes only the block that can hold the target.
+    class Cursor {
+    private:
+        const TitleIndexView* v_;
+        uint32_t firstBlock_, block_, blockEnd_;
+        uint32_t decoded_ = titles::kEnd;   // block held in docs_/tfs_
+        uint32_t count_ = 0, pos_ = 0;
+        uint32_t docs_[titles::kBlockSize], tfs_[titles::kBlockSize];
+
+        void decode(uint32_t b) {
+            const uint8_t* p = v_->postings + v_->blockOffset[b];
+            const uint8_t* end = v_->postings + v_->blockOffset[b + 1];
+            uint32_t prev = b == firstBlock_ ? 0 : v_->blockLast[b - 1] + 1;
+            count_ = pos_ = 0;
+            uint32_t word, tf;
+            while (count_ < titles::kBlockSize && titles::getVarint(p, end, word)) {
+                tf = 1;
+                if ((word & 1) && !titles::getVarint(p, end, tf)) break;
+                prev += word >> 1;
+                if (prev >= v_->docs) break;    // damaged list: stop here
+                docs_[count_] = prev;
+                tfs_[count_++] = tf;
+                ++prev;
+            }
+            decoded_ = b;
+        }
+
+    public:
+        Cursor(const TitleIndexView* v, uint32_t term)
+            : v_(v), firstBlock_(v->termBlocks[term]), block_(firstBlock_), blockEnd_(v->termBlocks[term + 1]) {}
+
+        // Term frequency at the id advance() last returned.
+        uint32_t tf() const { return tfs_[pos_]; }
+
+        // Moves to the first id >= target; returns it or titles::kEnd.
+        uint32_t advance(uint32_t target) {
+            for (; block_ < blockEnd_; ++block_) {
+                if (v_->blockLast[block_] < target) {
+                    uint32_t step = 1, lo = block_;
+                    while (block_ + step < blockEnd_ && v_->blockLast[block_ + step] < target) {
+                        lo = block_ + step;
+                        step <<= 1;
+                    }
+                    uint32_t hi = std::min(block_ + step + 1, blockEnd_);
+                    block_ = (uint32_t)(std::lower_bound(v_->blockLast + lo, v_->blockLast + hi, target) - v_->blockLast);
+                    if (block_ >= blockEnd_) break;
+                }
+                if (decoded_ != block_) decode(block_);
+                // Stepping to the next id is the common case; search otherwise.
+                if (pos_ < count_ && docs_[pos_] < target) ++pos_;
+                if (pos_ < count_ && docs_[pos_] < target)
+                    pos_ = (uint32_t)(std::lower_bound(docs_ + pos_, docs_ + count_, target) - docs_);
+                if (pos_ < count_) return docs_[pos_];
+                // Only a damaged block ends before its last id.
+            }
+            return titles::kEnd;
+        }
+    };
+
+    double idf(uint32_t t) const {
+        double n = indexedDocs, df = termDocs[t];
+        return std::log(1.0 + (n - df + 0.5) / (df + 0.5));
+    }
+
+    // BM25 of one term in one title; weight is idf(t) * (k1 + 1).
+    double bm25(double weight, uint32_t tf, uint32_t doc) const {
+        using namespace titles;
+        return weight * tf / (tf + kK1 * (1.0 - kB) + kK1 * kB / (avgLength > 0 ? avgLength : 1.0) * docLength[doc]);
+    }
+
+    // Finds the ids whose titles hold every term of query and keeps the k
+    // best in out, best first: higher score, then before(a, b) on the ids
+    // of equal scores. Returns how many ids matched in all. Unknown terms
+    // match nothing.
+    template <class Before>
+    size_t search(std::string_view query, size_t k, Before&& before, std::vector<Hit>& out) const {
+        out.clear();
+        std::string scratch;
+        std::vector<uint32_t> ids;
+        bool unknown = false;
+        titles::forEachTerm(query, scratch, [&](std::string_view s) {
+            uint32_t t = findTerm(s);
+            if (t == titles::kEnd) unknown = true;
+            else ids.push_back(t);
+        });
+        if (unknown || ids.empty() || k == 0) return 0;
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+        std::sort(ids.begin(), ids.end(), [&](uint32_t a, uint32_t b) { return termDocs[a] < termDocs[b]; });
+
+        std::vector<Cursor> cursors;
+        std::vector<double> weights;
+        cursors.reserve(ids.size());
+        for (uint32_t t : ids) {
+            cursors.emplace_back(this, t);
+            weights.push_back(idf(t) * (titles::kK1 + 1.0));
+        }
+
+        // out is a heap with the worst kept hit on top until the end.
+        auto better = [&](const Hit& x, const Hit& y) {
+            return x.score != y.score ? x.score > y.score : before(x.doc, y.doc);
+        };
+        size_t found = 0;
+
+        // The shortest list proposes ids; the others gallop to each one and
+        // a miss lets the lead skip ahead to where that list resumes.
+        Cursor& lead = cursors[0];
+        uint32_t d = lead.advance(0);
+        while (d != titles::kEnd) {
+            uint32_t got = d;
+            size_t i = 1;
+            for (; i < cursors.size() && (got = cursors[i].advance(d)) == d; ++i) {}
+            if (i < cursors.size()) {
+                if (got == titles::kEnd) break;
+                d = lead.advance(got);
+                continue;
+            }
+            ++found;
+            Hit h{ d, 0.0 };
+            for (size_t j = 0; j < cursors.size(); ++j) h.score += bm25(weights[j], cursors[j].tf(), d);
+            if (out.size() < k) {
+                out.push_back(h);
+                std::push_heap(out.begin(), out.end(), better);
+            }
+            else if (better(h, out.front())) {
+                std::pop_heap(out.begin(), out.end(), better);
+                out.back() = h;
+                std::push_heap(out.begin(), out.end(), better);
+            }
+            d = lead.advance(d + 1);
+        }
+        std::sort_heap(out.begin(), out.end(), better);
+        return found;
+    }
+};
+
+class TitleIndex {
+private:
+    std::vector<uint32_t> termOffsets_;
+    std::string termBytes_;
+    std::vector<uint32_t> termBlocks_, termDocs_, blockLast_, blockOffset_;
+    std::vector<uint8_t> postings_;
+    std::vector<uint16_t> docLength_;
+    uint32_t indexedDocs_ = 0;
+    uint64_t totalLength_ = 0;
+
+public:
+    // Indexes titleAt(id) for ids [0, docs); empty titles are skipped.
+    template <class TitleAt>
+    void build(uint32_t docs, TitleAt&& titleAt, ThreadPool* pool = nullptr) {
+        clear();
+        docLength_.assign(docs, 0);
+
+        // (term, doc, tf) in doc order, terms interned in first-seen order.
+        CodeInterner vocab;
+        struct Entry {
+            uint32_t term, doc, tf;
+        };
+        std::vector<Entry> entries;
+        std::vector<uint32_t> inDoc;
+        std::string scratch;
+        for (uint32_t d = 0; d < docs; ++d) {
+            inDoc.clear();
+            titles::forEachTerm(titleAt(d), scratch, [&](std::string_view s) { inDoc.push_back(vocab.intern(s)); });
+            if (inDoc.empty()) continue;
+            ++indexedDocs_;
+            totalLength_ += inDoc.size();
+            docLength_[d] = (uint16_t)std::min<size_t>(inDoc.size(), UINT16_MAX);
+            std::sort(inDoc.begin(), inDoc.end());
+            for (size_t i = 0, j; i < inDoc.size(); i = j) {
+                for (j = i + 1; j < inDoc.size() && inDoc[j] == inDoc[i]; ++j) {}
+                entries.push_back({ inDoc[i], d, (uint32_t)(j - i) });
+            }
+        }
+
+        // Vocabulary in byte order; rank[first-seen id] = final term id.
+        std::vector<uint32_t> order(vocab.size()), rank(vocab.size());
+        for (uint32_t t = 0; t < order.size(); ++t) order[t] = t;
+        radixSortByKey(order, [&](uint32_t t) { return vocab.name(t); }, pool);
+        termOffsets_.push_back(0);
+        for (uint32_t r = 0; r < order.size(); ++r) {
+            rank[order[r]] = r;
+            termBytes_.append(vocab.name(order[r]));
+            termOffsets_.push_back((uint32_t)termBytes_.size());
+        }
+
+        // Stable counting sort by term keeps each list in doc order.
+        termDocs_.assign(order.size(), 0);
+        for (const Entry& e : entries) ++termDocs_[rank[e.term]];
+        std::vector<uint32_t> start(order.size() + 1, 0);
+        for (size_t t = 0; t < order.size(); ++t) start[t + 1] = start[t] + termDocs_[t];
+        std::vector<Entry> byTerm(entries.size());
+        {
+            std::vector<uint32_t> cursor(start.begin(), start.end() - 1);
+            for (const Entry& e : entries) byTerm[cursor[rank[e.term]]++] = e;
+        }
+
+        termBlocks_.push_back(0);
+        blockOffset_.push_back(0);
+        for (size_t t = 0; t < order.size(); ++t) {
+            uint32_t prev = 0;
+            for (uint32_t i = start[t]; i < start[t + 1]; ++i) {
+                const Entry& e = byTerm[i];
+                titles::putVarint(postings_, (e.doc - prev) << 1 | (e.tf > 1));
+                if (e.tf > 1) titles::putVarint(postings_, e.tf);
+                prev = e.doc + 1;
+                if ((i - start[t]) % titles::kBlockSize == titles::kBlockSize - 1 || i + 1 == start[t + 1]) {
+                    blockLast_.push_back(e.doc);
+                    blockOffset_.push_back((uint32_t)postings_.size());
+                }
+            }
+            termBlocks_.push_back((uint32_t)blockLast_.size());
+        }
+    }
+
+    void clear() {
+        termOffsets_.clear();
+        termBytes_.clear();
+        termBlocks_.clear();
+        termDocs_.clear();
+        blockLast_.clear();
+        blockOffset_.clear();
+        postings_.clear();
+        docLength_.clear();
+        indexedDocs_ = 0;
+        totalLength_ = 0;
+    }
+
+    TitleIndexView view() const {
+        TitleIndexView v;
+        v.termOffsets = termOffsets_.data();
+        v.termBytes = termBytes_.data();
+        v.termBlocks = termBlocks_.data();
+        v.termDocs = termDocs_.data();
+        v.blockLast = blockLast_.data();
+        v.blockOffset = blockOffset_.data();
+        v.postings = postings_.data();
+        v.docLength = docLength_.data();
+        v.terms = (uint32_t)termDocs_.size();
+        v.docs = (uint32_t)docLength_.size();
+        v.indexedDocs = indexedDocs_;
+        v.avgLength = indexedDocs_ ? (double)totalLength_ / indexedDocs_ : 0.0;
+        return v;
+    }
+
+    const std::vector<uint32_t>& termOffsets() const { return termOffsets_; }
+    const std::string& termBytes() const { return termBytes_; }
+    const std::vector<uint32_t>& termBlocks() const { return termBlocks_; }
+    const std::vector<uint32_t>& termDocs() const { return termDocs_; }
+    const std::vector<uint32_t>& blockLast() const { return blockLast_; }
+    const std::vector<uint32_t>& blockOffset() const { return blockOffset_; }
+    const std::vector<uint8_t>& postings() const { return postings_; }
+    const std::vector<uint16_t>& docLength() const { return docLength_; }
+    uint32_t indexedDocs() const { return indexedDocs_; }
+    uint64_t totalLength() const { return totalLength_; }
+
+    size_t memoryBytes() const {
+        return (termOffsets_.capacity() + termBlocks_.capacity() + termDocs_.capacity() + blockLast_.capacity() +
+            blockOffset_.capacity()) * sizeof(uint32_t) + termBytes_.capacity() + postings_.capacity() +
+            docLength_.capacity() * sizeof(uint16_t);
+    }
+};